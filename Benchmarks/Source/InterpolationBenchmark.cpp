@@ -0,0 +1,196 @@
+#include "InterpolationBenchmark.h"
+
+#if JUCE_INTEL
+ #if JUCE_MSVC
+  #include <intrin.h>
+ #else
+  #include <x86intrin.h>
+ #endif
+#endif
+
+#define INTERPOLATION_TABLE_SIZE 1024
+#define INTERPOLATION_VOICE_BLOCK_SIZE 64
+#define INTERPOLATION_NUM_VOICE_BLOCKS 256
+#define INTERPOLATION_FFT_ORDER 14
+#define INTERPOLATION_MAX_DETUNE 0.05
+#define INTERPOLATION_RANDOM_SEED 0x5eed
+
+//================================================================================================
+// CYCLE COUNTER
+
+// time stamp counter where the cpu has one, otherwise wall time scaled by the nominal clock
+static double measureCycles(juce::int64 startTicks, juce::uint64 startCycles)
+{
+   #if JUCE_INTEL
+    juce::ignoreUnused(startTicks);
+    return (double) (__rdtsc() - startCycles);
+   #else
+    juce::ignoreUnused(startCycles);
+    auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    return seconds * juce::SystemStats::getCpuSpeedInMegahertz() * 1.0e6;
+   #endif
+}
+
+static juce::uint64 readCycleCounter()
+{
+   #if JUCE_INTEL
+    return (juce::uint64) __rdtsc();
+   #else
+    return 0;
+   #endif
+}
+
+//================================================================================================
+// CONSTRUCTORS / DESTRUCTORS
+
+InterpolationBenchmark::InterpolationBenchmark(double sampleRate, double seconds) :
+    outputSampleRate(sampleRate),
+    secondsPerCase(seconds),
+    fft(INTERPOLATION_FFT_ORDER)
+{
+    // exactly one period, so any distortion measured comes from the kernel
+    sineTable.resize(INTERPOLATION_TABLE_SIZE);
+    for (int i = 0; i < INTERPOLATION_TABLE_SIZE; ++i)
+    {
+        sineTable[(size_t) i] = (float) std::sin(juce::MathConstants<double>::twoPi * i / INTERPOLATION_TABLE_SIZE);
+    }
+
+    renderBuffer.resize((size_t) juce::jmax(INTERPOLATION_VOICE_BLOCK_SIZE, fft.getSize()));
+    fftData.resize(2 * (size_t) fft.getSize());
+}
+
+InterpolationBenchmark::~InterpolationBenchmark()
+{
+}
+
+//================================================================================================
+// CASES
+
+std::vector<InterpolationKernel> InterpolationBenchmark::getKernels()
+{
+    return {
+        { "linear",        renderLinearBlock },
+        { "linear-simd",   renderLinearBlockSimd },
+        { "hermite",       renderHermiteBlock },
+        { "hermite-simd",  renderHermiteBlockSimd },
+        { "hermite6",      renderHermite6Block },
+        { "hermite6-simd", renderHermite6BlockSimd },
+        { "sinc8",         renderSinc8Block },
+        { "sinc16",        renderSinc16Block },
+        { "sinc32",        renderSinc32Block }
+    };
+}
+
+std::vector<PhaseIncrementDistribution> InterpolationBenchmark::getDistributions()
+{
+    return {
+        { "bass", 24, 48 },
+        { "mid",  48, 72 },
+        { "lead", 72, 96 },
+        { "top",  96, 120 }
+    };
+}
+
+//================================================================================================
+// RUN
+
+InterpolationResult InterpolationBenchmark::run(const InterpolationKernel &kernel, const PhaseIncrementDistribution &distribution, int oversamplingFactor)
+{
+    InterpolationResult result;
+    result.kernelName = kernel.name;
+    result.distributionName = distribution.name;
+    result.oversamplingFactor = oversamplingFactor;
+
+    measureCost(kernel, distribution, oversamplingFactor, result);
+    measureQuality(kernel, distribution, oversamplingFactor, result);
+    return result;
+}
+
+// short blocks at random detuned notes, the way unison voices hit the kernel
+void InterpolationBenchmark::measureCost(const InterpolationKernel &kernel, const PhaseIncrementDistribution &distribution, int oversamplingFactor, InterpolationResult &result)
+{
+    const double renderSampleRate = outputSampleRate * oversamplingFactor;
+
+    juce::Random random(INTERPOLATION_RANDOM_SEED);
+    std::vector<float> phaseIncrements(INTERPOLATION_NUM_VOICE_BLOCKS);
+    for (auto &phaseIncrement : phaseIncrements)
+    {
+        auto note = distribution.lowestNote + random.nextInt(distribution.highestNote - distribution.lowestNote + 1);
+        auto detune = 1.0 + INTERPOLATION_MAX_DETUNE * (2.0 * random.nextDouble() - 1.0);
+        phaseIncrement = (float) (juce::MidiMessage::getMidiNoteInHertz(note) * detune / renderSampleRate);
+    }
+
+    auto renderPass = [&] {
+        float phase = 0.f;
+        for (auto phaseIncrement : phaseIncrements)
+            phase = kernel.render(sineTable.data(), INTERPOLATION_TABLE_SIZE, phase, phaseIncrement, renderBuffer.data(), INTERPOLATION_VOICE_BLOCK_SIZE);
+        return phase;
+    };
+
+    // warm up caches and branch predictors
+    volatile float sink = renderPass();
+
+    const auto samplesPerPass = (double) INTERPOLATION_NUM_VOICE_BLOCKS * INTERPOLATION_VOICE_BLOCK_SIZE;
+    const auto targetTicks = juce::Time::secondsToHighResolutionTicks(secondsPerCase);
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+    const auto startCycles = readCycleCounter();
+
+    juce::int64 numPasses = 0;
+    do
+    {
+        sink = sink + renderPass();
+        ++numPasses;
+    }
+    while (juce::Time::getHighResolutionTicks() - startTicks < targetTicks);
+
+    const auto cycles = measureCycles(startTicks, startCycles);
+    const auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    const auto numSamples = samplesPerPass * (double) numPasses;
+
+    result.cyclesPerSample = cycles / numSamples;
+    result.nanosecondsPerSample = seconds * 1.0e9 / numSamples;
+}
+
+// a sine at the top of the distribution, snapped to an fft bin; the phase increment is then
+// an exact binary fraction, so the phase never drifts and no analysis window is needed.
+// only the band that survives decimation back to the output rate is analysed: harmonics of
+// the note count as distortion, every other bin as aliasing from the interpolation images
+void InterpolationBenchmark::measureQuality(const InterpolationKernel &kernel, const PhaseIncrementDistribution &distribution, int oversamplingFactor, InterpolationResult &result)
+{
+    const int fftSize = fft.getSize();
+    const double renderSampleRate = outputSampleRate * oversamplingFactor;
+
+    const auto noteHz = juce::MidiMessage::getMidiNoteInHertz(distribution.highestNote);
+    const int fundamentalBin = juce::jmax(1, juce::roundToInt(noteHz / renderSampleRate * fftSize));
+    const float phaseIncrement = (float) fundamentalBin / (float) fftSize;
+    const int lastBin = fftSize / (2 * oversamplingFactor);
+
+    kernel.render(sineTable.data(), INTERPOLATION_TABLE_SIZE, 0.f, phaseIncrement, renderBuffer.data(), fftSize);
+
+    std::fill(fftData.begin(), fftData.end(), 0.f);
+    std::copy(renderBuffer.begin(), renderBuffer.begin() + fftSize, fftData.begin());
+    fft.performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+    const double fundamentalPower = juce::square((double) fftData[(size_t) fundamentalBin]);
+    double residualPower = 0.0;
+    double peakAliasPower = 0.0;
+
+    for (int bin = 1; bin <= lastBin; ++bin)
+    {
+        if (bin == fundamentalBin)
+            continue;
+
+        const double power = juce::square((double) fftData[(size_t) bin]);
+        residualPower += power;
+
+        if (bin % fundamentalBin != 0)
+            peakAliasPower = juce::jmax(peakAliasPower, power);
+    }
+
+    auto toDecibels = [fundamentalPower](double power) {
+        return power > 0.0 ? 10.0 * std::log10(power / fundamentalPower) : -300.0;
+    };
+
+    result.thdPlusNoiseDecibels = toDecibels(residualPower);
+    result.aliasDecibels = toDecibels(peakAliasPower);
+}
@@ -0,0 +1,69 @@
+#ifndef INTERPOLATION_BENCHMARK_H
+#define INTERPOLATION_BENCHMARK_H
+
+#include <JuceHeader.h>
+#include "../../Source/Synthesizer/Interpolation.h"
+
+//================================================================================================
+// a range of notes as the oscillator would play them, detuned like its unison voices
+
+struct PhaseIncrementDistribution
+{
+    const char *name;
+    int lowestNote;
+    int highestNote;
+};
+
+struct InterpolationKernel
+{
+    const char *name;
+    InterpolationBlockKernel render;
+};
+
+struct InterpolationResult
+{
+    juce::String kernelName;
+    juce::String distributionName;
+    int oversamplingFactor;
+
+    double cyclesPerSample;
+    double nanosecondsPerSample;
+    double thdPlusNoiseDecibels;
+    double aliasDecibels;
+};
+
+//================================================================================================
+// cost of each interpolation kernel over realistic phase increments, and the distortion
+// and aliasing it adds to a pure sine table at the highest note of each distribution
+
+class InterpolationBenchmark
+{
+public:
+
+    // CONSTRUCTORS / DESTRUCTORS
+    InterpolationBenchmark(double outputSampleRate, double secondsPerCase);
+    ~InterpolationBenchmark();
+
+    // CASES
+    static std::vector<InterpolationKernel> getKernels();
+    static std::vector<PhaseIncrementDistribution> getDistributions();
+
+    // RUN
+    InterpolationResult run(const InterpolationKernel &kernel, const PhaseIncrementDistribution &distribution, int oversamplingFactor);
+
+private:
+
+    double outputSampleRate;
+    double secondsPerCase;
+
+    std::vector<float> sineTable;
+    std::vector<float> renderBuffer;
+
+    juce::dsp::FFT fft;
+    std::vector<float> fftData;
+
+    void measureCost(const InterpolationKernel &kernel, const PhaseIncrementDistribution &distribution, int oversamplingFactor, InterpolationResult &result);
+    void measureQuality(const InterpolationKernel &kernel, const PhaseIncrementDistribution &distribution, int oversamplingFactor, InterpolationResult &result);
+};
+
+#endif // INTERPOLATION_BENCHMARK_H
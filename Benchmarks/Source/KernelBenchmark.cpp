@@ -0,0 +1,130 @@
+#include "KernelBenchmark.h"
+
+#define KERNEL_TABLE_SIZE 2048
+#define KERNEL_BLOCK_SIZE 128
+#define KERNEL_NUM_BLOCKS 64
+#define KERNEL_RANDOM_SEED 0x5eed
+
+enum BenchmarkedKernels {
+    ApplyGainKernel = 0,
+    MixMonoKernel,
+    MixStereoKernel,
+    MixMidSideKernel,
+    AddKernel,
+    RenderBlockKernel,
+    NumBenchmarkedKernels = RenderBlockKernel + NumInterpolationModes
+};
+
+//================================================================================================
+// CONSTRUCTORS / DESTRUCTORS
+
+KernelBenchmark::KernelBenchmark(double seconds) :
+    secondsPerCase(seconds)
+{
+    juce::Random random(KERNEL_RANDOM_SEED);
+    auto fill = [&random](std::vector<float> &signal, int size) {
+        signal.resize((size_t) size);
+        for (auto &value : signal)
+            value = 2.f * random.nextFloat() - 1.f;
+    };
+
+    fill(table, KERNEL_TABLE_SIZE);
+    fill(inputA, KERNEL_BLOCK_SIZE);
+    fill(inputB, KERNEL_BLOCK_SIZE);
+    fill(gains, KERNEL_BLOCK_SIZE);
+    fill(outputLeft, KERNEL_BLOCK_SIZE);
+    fill(outputRight, KERNEL_BLOCK_SIZE);
+}
+
+KernelBenchmark::~KernelBenchmark()
+{
+}
+
+//================================================================================================
+// CASES
+
+std::vector<juce::String> KernelBenchmark::getKernelNames()
+{
+    std::vector<juce::String> names = { "applyGain", "mixMono", "mixStereo", "mixMidSide", "add" };
+    for (int mode = 0; mode < NumInterpolationModes; ++mode)
+        names.push_back(juce::String("renderBlock ") + getInterpolationModeName(mode));
+
+    return names;
+}
+
+//================================================================================================
+// RUN
+
+KernelResult KernelBenchmark::run(int kernelIndex)
+{
+    jassert((int) getKernelNames().size() == NumBenchmarkedKernels);
+
+    KernelResult result;
+    result.kernelName = getKernelNames()[(size_t) kernelIndex];
+
+    for (int isa = 0; isa < NumDspIsas; ++isa)
+    {
+        const auto *kernels = getDspKernels((DspIsa) isa);
+        result.nanosecondsPerSample[isa] = kernels != nullptr ? measure(*kernels, kernelIndex) : -1.0;
+    }
+
+    return result;
+}
+
+// with denormals flushed, as on the audio thread, so a decaying block does not slow down
+double KernelBenchmark::measure(const DspKernels &kernels, int kernelIndex)
+{
+    juce::ScopedNoDenormals noDenormals;
+
+    // warm up caches and branch predictors
+    renderPass(kernels, kernelIndex);
+
+    const auto targetTicks = juce::Time::secondsToHighResolutionTicks(secondsPerCase);
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+
+    juce::int64 numPasses = 0;
+    do
+    {
+        renderPass(kernels, kernelIndex);
+        ++numPasses;
+    }
+    while (juce::Time::getHighResolutionTicks() - startTicks < targetTicks);
+
+    const auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    return seconds * 1.0e9 / ((double) numPasses * KERNEL_NUM_BLOCKS * KERNEL_BLOCK_SIZE);
+}
+
+// the accumulating kernels keep adding into the same block; the gains are small enough
+// that it stays finite over any realistic run
+void KernelBenchmark::renderPass(const DspKernels &kernels, int kernelIndex)
+{
+    float phase = 0.f;
+
+    for (int block = 0; block < KERNEL_NUM_BLOCKS; ++block)
+    {
+        switch (kernelIndex)
+        {
+            case ApplyGainKernel:
+                kernels.applyGain(outputLeft.data(), inputA.data(), 1.f, KERNEL_BLOCK_SIZE);
+                break;
+            case MixMonoKernel:
+                kernels.mixMono(outputLeft.data(), inputA.data(), gains.data(), 1.0e-6f, KERNEL_BLOCK_SIZE);
+                break;
+            case MixStereoKernel:
+                kernels.mixStereo(outputLeft.data(), outputRight.data(), inputA.data(), gains.data(), 1.0e-6f, 1.0e-6f, KERNEL_BLOCK_SIZE);
+                break;
+            case MixMidSideKernel:
+                kernels.mixMidSide(outputLeft.data(), outputRight.data(), inputA.data(), inputB.data(), gains.data(),
+                                   inputA.data(), inputB.data(), KERNEL_BLOCK_SIZE);
+                break;
+            case AddKernel:
+                kernels.add(outputLeft.data(), inputA.data(), KERNEL_BLOCK_SIZE);
+                break;
+            default:
+                // one block kernel per interpolation mode
+                phase = kernels.renderBlock[kernelIndex - RenderBlockKernel](table.data(), KERNEL_TABLE_SIZE, phase, 0.0123f + 0.0001f * (float) block,
+                                                                             outputLeft.data(), KERNEL_BLOCK_SIZE);
+                break;
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef KERNEL_BENCHMARK_H
+#define KERNEL_BENCHMARK_H
+
+#include <JuceHeader.h>
+#include "../../Source/Synthesizer/DspKernels.h"
+
+//================================================================================================
+// one row of the side-by-side table: a kernel timed in every variant this cpu can run,
+// nanoseconds per sample or a negative value where the variant is unavailable
+
+struct KernelResult
+{
+    juce::String kernelName;
+    double nanosecondsPerSample[NumDspIsas];
+};
+
+//================================================================================================
+// cost of each dispatched dsp kernel on voice-sized blocks, per instruction set
+
+class KernelBenchmark
+{
+public:
+
+    // CONSTRUCTORS / DESTRUCTORS
+    KernelBenchmark(double secondsPerCase);
+    ~KernelBenchmark();
+
+    // CASES
+    static std::vector<juce::String> getKernelNames();
+
+    // RUN, kernelIndex into getKernelNames()
+    KernelResult run(int kernelIndex);
+
+private:
+
+    double secondsPerCase;
+
+    std::vector<float> table;
+    std::vector<float> inputA;
+    std::vector<float> inputB;
+    std::vector<float> gains;
+    std::vector<float> outputLeft;
+    std::vector<float> outputRight;
+
+    double measure(const DspKernels &kernels, int kernelIndex);
+    void renderPass(const DspKernels &kernels, int kernelIndex);
+};
+
+#endif // KERNEL_BENCHMARK_H
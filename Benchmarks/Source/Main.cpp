@@ -0,0 +1,275 @@
+/*
+  ==============================================================================
+
+    Headless benchmarks of the synthesizer render path.
+
+    usage: WavetableSynthBenchmarks [--quick | --block-sweep] [--mono] [--interpolator <mode>] [--seconds <n>]
+                                    [--filter <text>] [--baseline <file>] [--save-baseline <file>]
+           WavetableSynthBenchmarks --interpolation [--seconds <n>] [--filter <text>]
+           WavetableSynthBenchmarks --kernels [--seconds <n>] [--filter <text>]
+           WavetableSynthBenchmarks --regression <reference directory> [--update-references]
+                                    [--report <file>] [--filter <text>]
+
+    the regression references live in Benchmarks/References, one wav per scenario. after a
+    change that is meant to alter the output, or after adding a scenario, regenerate them from
+    a release build with --regression Benchmarks/References --update-references and commit
+    the wavs. exits with 1 when a comparison fails and 2 when only references are missing
+
+  ==============================================================================
+*/
+
+#include <iostream>
+#include <JuceHeader.h>
+#include "SynthesizerBenchmark.h"
+#include "InterpolationBenchmark.h"
+#include "KernelBenchmark.h"
+#include "RegressionSuite.h"
+
+//==============================================================================
+static void printResult(const BenchmarkResult &result, const std::map<juce::String, double> &baseline)
+{
+    auto name = result.benchmarkCase.getName();
+    auto line = name.paddedRight(' ', 52)
+        + juce::String(result.nanosecondsPerSample, 1).paddedLeft(' ', 12)
+        + juce::String(result.realtimeFactor, 1).paddedLeft(' ', 10)
+        + juce::String(result.voicesPerCore, 1).paddedLeft(' ', 12);
+
+    auto baselineEntry = baseline.find(name);
+    if (baselineEntry != baseline.end() && baselineEntry->second > 0.0)
+    {
+        auto change = 100.0 * (result.nanosecondsPerSample - baselineEntry->second) / baselineEntry->second;
+        line += ((change >= 0.0 ? "+" : "") + juce::String(change, 1) + "%").paddedLeft(' ', 10);
+    }
+
+    std::cout << line << std::endl;
+}
+
+static void printInterpolationResult(const InterpolationResult &result)
+{
+    auto name = result.kernelName + "_" + result.distributionName + "_os" + juce::String(result.oversamplingFactor) + "x";
+    std::cout << name.paddedRight(' ', 28)
+              << juce::String(result.cyclesPerSample, 2).paddedLeft(' ', 14)
+              << juce::String(result.nanosecondsPerSample, 2).paddedLeft(' ', 12)
+              << juce::String(result.thdPlusNoiseDecibels, 1).paddedLeft(' ', 10)
+              << juce::String(result.aliasDecibels, 1).paddedLeft(' ', 10)
+              << std::endl;
+}
+
+static int runInterpolationBenchmarks(const juce::ArgumentList &arguments)
+{
+    const auto secondsPerCase = arguments.containsOption("--seconds") ? arguments.getValueForOption("--seconds").getDoubleValue() : 0.25;
+    const auto filter = arguments.getValueForOption("--filter");
+
+    std::cout << juce::String("kernel").paddedRight(' ', 28)
+              << juce::String("cycles/sample").paddedLeft(' ', 14)
+              << juce::String("ns/sample").paddedLeft(' ', 12)
+              << juce::String("THD+N dB").paddedLeft(' ', 10)
+              << juce::String("alias dB").paddedLeft(' ', 10)
+              << std::endl;
+
+    InterpolationBenchmark benchmark(48000.0, juce::jmax(0.01, secondsPerCase));
+
+    for (const auto &kernel : InterpolationBenchmark::getKernels())
+    {
+        if (filter.isNotEmpty() && !juce::String(kernel.name).contains(filter))
+            continue;
+
+        for (const auto &distribution : InterpolationBenchmark::getDistributions())
+            for (auto oversamplingFactor : { 1, 4 })
+                printInterpolationResult(benchmark.run(kernel, distribution, oversamplingFactor));
+    }
+
+    return 0;
+}
+
+// self-test first, then every kernel with one column per instruction set
+static int runKernelBenchmarks(const juce::ArgumentList &arguments)
+{
+    const auto secondsPerCase = arguments.containsOption("--seconds") ? arguments.getValueForOption("--seconds").getDoubleValue() : 0.1;
+    const auto filter = arguments.getValueForOption("--filter");
+
+    juce::String failureMessage;
+    const bool selfTestPassed = runDspKernelSelfTest(failureMessage);
+    std::cout << "self-test " << (selfTestPassed ? juce::String("pass") : "FAIL: " + failureMessage)
+              << ", selected " << getDspKernels().name << std::endl << std::endl;
+
+    auto header = juce::String("kernel (ns/sample)").paddedRight(' ', 24);
+    for (int isa = 0; isa < NumDspIsas; ++isa)
+    {
+        const auto *kernels = getDspKernels((DspIsa) isa);
+        header += juce::String(kernels != nullptr ? kernels->name : "-").paddedLeft(' ', 12);
+    }
+    std::cout << header << std::endl;
+
+    KernelBenchmark benchmark(juce::jmax(0.01, secondsPerCase));
+    const auto kernelNames = KernelBenchmark::getKernelNames();
+
+    for (int kernelIndex = 0; kernelIndex < (int) kernelNames.size(); ++kernelIndex)
+    {
+        if (filter.isNotEmpty() && !kernelNames[(size_t) kernelIndex].contains(filter))
+            continue;
+
+        const auto result = benchmark.run(kernelIndex);
+        auto line = result.kernelName.paddedRight(' ', 24);
+        for (auto nanoseconds : result.nanosecondsPerSample)
+            line += (nanoseconds >= 0.0 ? juce::String(nanoseconds, 3) : juce::String("-")).paddedLeft(' ', 12);
+
+        std::cout << line << std::endl;
+    }
+
+    return selfTestPassed ? 0 : 1;
+}
+
+static void printRegressionResult(const RegressionResult &result)
+{
+    auto status = result.referenceWritten ? juce::String("written")
+                : result.referenceMissing ? juce::String("missing")
+                : juce::String(result.passed ? "pass" : "FAIL");
+    std::cout << result.name.paddedRight(' ', 28)
+              << status.paddedLeft(' ', 8)
+              << juce::String(result.maximumError, 7).paddedLeft(' ', 12)
+              << juce::String(result.tolerance, 7).paddedLeft(' ', 12)
+              << juce::String(result.rmsErrorDecibels, 1).paddedLeft(' ', 10)
+              << juce::String(result.nanosecondsPerSample, 1).paddedLeft(' ', 12)
+              << juce::String(result.realtimeFactor, 1).paddedLeft(' ', 10)
+              << std::endl;
+
+    if (result.error.isNotEmpty())
+        std::cout << "    " << result.error << std::endl;
+}
+
+static int runRegressionSuite(const juce::ArgumentList &arguments)
+{
+    const auto referenceDirectory = arguments.getFileForOption("--regression");
+    const bool updateReferences = arguments.containsOption("--update-references");
+    const auto filter = arguments.getValueForOption("--filter");
+
+    std::cout << juce::String("scenario").paddedRight(' ', 28)
+              << juce::String("result").paddedLeft(' ', 8)
+              << juce::String("max error").paddedLeft(' ', 12)
+              << juce::String("tolerance").paddedLeft(' ', 12)
+              << juce::String("rms dB").paddedLeft(' ', 10)
+              << juce::String("ns/sample").paddedLeft(' ', 12)
+              << juce::String("x realtime").paddedLeft(' ', 10)
+              << std::endl;
+
+    RegressionSuite suite(referenceDirectory);
+    std::vector<RegressionResult> results;
+    int numFailed = 0;
+    int numMissing = 0;
+
+    for (const auto &scenario : RegressionSuite::createScenarios())
+    {
+        if (filter.isNotEmpty() && !scenario.name.contains(filter))
+            continue;
+
+        results.push_back(suite.run(scenario, updateReferences));
+        printRegressionResult(results.back());
+
+        if (results.back().referenceMissing)
+            ++numMissing;
+        else if (!results.back().passed)
+            ++numFailed;
+    }
+
+    if (arguments.containsOption("--report"))
+    {
+        auto file = arguments.getFileForOption("--report");
+        if (!saveRegressionReport(file, results))
+        {
+            std::cerr << "could not write report to " << file.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+
+    if (numFailed > 0)
+        return 1;
+
+    return numMissing == 0 ? 0 : 2;
+}
+
+int main (int argc, char* argv[])
+{
+    juce::ArgumentList arguments(argc, argv);
+
+    if (arguments.containsOption("--interpolation"))
+        return runInterpolationBenchmarks(arguments);
+
+    if (arguments.containsOption("--kernels"))
+        return runKernelBenchmarks(arguments);
+
+    if (arguments.containsOption("--regression"))
+        return runRegressionSuite(arguments);
+
+    const bool quick = arguments.containsOption("--quick");
+    const auto secondsOfAudio = arguments.containsOption("--seconds") ? arguments.getValueForOption("--seconds").getDoubleValue() : 1.0;
+    const auto filter = arguments.getValueForOption("--filter");
+
+    std::map<juce::String, double> baseline;
+    if (arguments.containsOption("--baseline"))
+    {
+        auto file = arguments.getFileForOption("--baseline");
+        if (!file.existsAsFile())
+        {
+            std::cerr << "baseline " << file.getFullPathName() << " does not exist" << std::endl;
+            return 1;
+        }
+        baseline = loadBaseline(file);
+    }
+
+    std::cout << juce::String("case").paddedRight(' ', 52)
+              << juce::String("ns/sample").paddedLeft(' ', 12)
+              << juce::String("x realtime").paddedLeft(' ', 10)
+              << juce::String("voices/core").paddedLeft(' ', 12)
+              << (baseline.empty() ? "" : juce::String("vs base").paddedLeft(' ', 10))
+              << std::endl;
+
+    SynthesizerBenchmark benchmark(juce::jmax(0.01, secondsOfAudio));
+    std::vector<BenchmarkResult> results;
+
+    auto benchmarkCases = arguments.containsOption("--block-sweep") ? SynthesizerBenchmark::createBlockSizeSweep()
+                                                                    : SynthesizerBenchmark::createMatrix(quick);
+
+    // the same cases rendered to a mono output
+    if (arguments.containsOption("--mono"))
+    {
+        for (auto &benchmarkCase : benchmarkCases)
+            benchmarkCase.numChannels = 1;
+    }
+
+    // any interpolation mode name; hermite when not given
+    if (arguments.containsOption("--interpolator"))
+    {
+        const auto modeName = arguments.getValueForOption("--interpolator");
+        const int interpolationMode = parseInterpolationMode(modeName, -1);
+        if (interpolationMode < 0)
+        {
+            std::cerr << "unknown interpolator " << modeName << std::endl;
+            return 1;
+        }
+
+        for (auto &benchmarkCase : benchmarkCases)
+            benchmarkCase.interpolationMode = interpolationMode;
+    }
+
+    for (const auto &benchmarkCase : benchmarkCases)
+    {
+        if (filter.isNotEmpty() && !benchmarkCase.getName().contains(filter))
+            continue;
+
+        results.push_back(benchmark.run(benchmarkCase));
+        printResult(results.back(), baseline);
+    }
+
+    if (arguments.containsOption("--save-baseline"))
+    {
+        auto file = arguments.getFileForOption("--save-baseline");
+        if (!saveBaseline(file, results))
+        {
+            std::cerr << "could not write baseline to " << file.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
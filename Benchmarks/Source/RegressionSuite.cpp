@@ -0,0 +1,319 @@
+#include "RegressionSuite.h"
+#include "../../Source/Synthesizer/WavetableGenerators.h"
+
+//================================================================================================
+// SCENARIOS
+
+static void configureUnison(Synthesizer &synthesizer, int unisonVoices)
+{
+    synthesizer.setDetuneVoices(unisonVoices);
+    synthesizer.setDetuneSpread(0.5f);
+    synthesizer.setDetuneMix(1.f);
+    synthesizer.setVolume(0.25f);
+    synthesizer.setAdsrParameters(0.005f, 0.2f, 0.7f, 0.1f);
+}
+
+std::vector<RegressionScenario> RegressionSuite::createScenarios()
+{
+    std::vector<RegressionScenario> scenarios;
+
+    // four note chord held and released, exercises mixing of unison voices
+    scenarios.push_back({ "chord", 1.5, 1.0e-4f,
+        [](Synthesizer &synthesizer) { configureUnison(synthesizer, 7); },
+        [](juce::MidiMessageSequence &sequence)
+        {
+            for (auto note : { 48, 55, 60, 64 })
+            {
+                sequence.addEvent(juce::MidiMessage::noteOn(1, note, (juce::uint8) 100), 0.0);
+                sequence.addEvent(juce::MidiMessage::noteOff(1, note), 1.0);
+            }
+        },
+        {} });
+
+    // widest unison on two notes, every lane group of the vectorized unison path in use
+    scenarios.push_back({ "supersaw", 1.2, 2.0e-4f,
+        [](Synthesizer &synthesizer) { configureUnison(synthesizer, MAX_DETUNE_VOICES); },
+        [](juce::MidiMessageSequence &sequence)
+        {
+            for (auto note : { 45, 57 })
+            {
+                sequence.addEvent(juce::MidiMessage::noteOn(1, note, (juce::uint8) 100), 0.0);
+                sequence.addEvent(juce::MidiMessage::noteOff(1, note), 0.9);
+            }
+        },
+        {} });
+
+    // full-range bend up and back down; errors in the phase increment accumulate here
+    scenarios.push_back({ "pitch_bend_sweep", 1.3, 5.0e-4f,
+        [](Synthesizer &synthesizer) { configureUnison(synthesizer, 3); },
+        [](juce::MidiMessageSequence &sequence)
+        {
+            sequence.addEvent(juce::MidiMessage::noteOn(1, 57, (juce::uint8) 110), 0.0);
+
+            const int numSteps = 64;
+            for (int step = 0; step <= numSteps; ++step)
+            {
+                const auto position = 1.0 - std::abs(2.0 * step / numSteps - 1.0);
+                sequence.addEvent(juce::MidiMessage::pitchWheel(1, juce::roundToInt(8192.0 + position * 8191.0)), 0.1 + step * (1.0 / numSteps));
+            }
+
+            sequence.addEvent(juce::MidiMessage::noteOff(1, 57), 1.15);
+        },
+        {} });
+
+    // frame index moved every block across a many-frame table
+    scenarios.push_back({ "wavetable_position_sweep", 1.0, 1.0e-4f,
+        [](Synthesizer &synthesizer)
+        {
+            Wavetable frames;
+            generateManySineFrames(frames);
+            synthesizer.setWavetable(frames);
+            configureUnison(synthesizer, 1);
+        },
+        [](juce::MidiMessageSequence &sequence)
+        {
+            sequence.addEvent(juce::MidiMessage::noteOn(1, 45, (juce::uint8) 127), 0.0);
+            sequence.addEvent(juce::MidiMessage::noteOff(1, 45), 0.9);
+        },
+        [](Synthesizer &synthesizer, double blockStartSeconds)
+        {
+            const auto position = juce::jlimit(0.0, 1.0, blockStartSeconds / 0.9);
+            synthesizer.setWavetableFrameIndex((int) std::floor(position * (synthesizer.getNumWavetableFrames() - 1)));
+        } });
+
+    // more overlapping notes than voices, so the oldest ones are stolen
+    scenarios.push_back({ "voice_stealing", 1.2, 2.0e-4f,
+        [](Synthesizer &synthesizer) { configureUnison(synthesizer, 2); },
+        [](juce::MidiMessageSequence &sequence)
+        {
+            const int numNotes = MAX_POLYPHONY + 8;
+            for (int note = 0; note < numNotes; ++note)
+            {
+                sequence.addEvent(juce::MidiMessage::noteOn(1, 36 + note * 2, (juce::uint8) (60 + note)), note * 0.025);
+            }
+
+            for (int note = 0; note < numNotes; ++note)
+            {
+                sequence.addEvent(juce::MidiMessage::noteOff(1, 36 + note * 2), 0.9);
+            }
+        },
+        {} });
+
+    // resonant low-pass opened by the envelope and tracking the keyboard, per-voice filters
+    scenarios.push_back({ "filter_envelope", 1.2, 2.0e-4f,
+        [](Synthesizer &synthesizer)
+        {
+            configureUnison(synthesizer, 3);
+            synthesizer.setFilterParameters(FilterLowPass, 300.f, 0.7f, 0.8f, 0.5f);
+        },
+        [](juce::MidiMessageSequence &sequence)
+        {
+            for (auto note : { 36, 48, 60, 67, 79 })
+            {
+                sequence.addEvent(juce::MidiMessage::noteOn(1, note, (juce::uint8) 100), 0.0);
+                sequence.addEvent(juce::MidiMessage::noteOff(1, note), 0.8);
+            }
+        },
+        {} });
+
+    return scenarios;
+}
+
+//================================================================================================
+// CONSTRUCTORS / DESTRUCTORS
+
+RegressionSuite::RegressionSuite(const juce::File &directory) :
+    referenceDirectory(directory)
+{
+    Wavetable saw;
+    generateSawWavetable(saw, 1024);
+    wavetable = std::make_shared<const Wavetable>(std::move(saw));
+}
+
+RegressionSuite::~RegressionSuite()
+{
+}
+
+//================================================================================================
+// RUN
+
+RegressionResult RegressionSuite::run(const RegressionScenario &scenario, bool updateReference)
+{
+    RegressionResult result;
+    result.name = scenario.name;
+    result.tolerance = scenario.tolerance;
+
+    double renderSeconds = 0.0;
+    auto audio = render(scenario, renderSeconds);
+
+    result.nanosecondsPerSample = renderSeconds * 1.0e9 / audio.getNumSamples();
+    result.realtimeFactor = renderSeconds > 0.0 ? scenario.lengthSeconds / renderSeconds : 0.0;
+
+    auto referenceFile = referenceDirectory.getChildFile(scenario.name + ".wav");
+
+    if (updateReference)
+    {
+        result.referenceWritten = writeReference(referenceFile, audio);
+        result.passed = result.referenceWritten;
+        if (!result.referenceWritten)
+            result.error = "could not write " + referenceFile.getFullPathName();
+        return result;
+    }
+
+    if (!referenceFile.existsAsFile())
+    {
+        result.referenceMissing = true;
+        result.error = "missing reference " + referenceFile.getFullPathName() + ", create it with --update-references";
+        return result;
+    }
+
+    juce::AudioBuffer<float> reference;
+    if (!readReference(referenceFile, reference))
+    {
+        result.error = "could not read reference " + referenceFile.getFullPathName();
+        return result;
+    }
+
+    if (reference.getNumChannels() != audio.getNumChannels() || reference.getNumSamples() != audio.getNumSamples())
+    {
+        result.error = "reference has a different length or channel count";
+        return result;
+    }
+
+    double sumOfSquaredErrors = 0.0;
+    for (int channel = 0; channel < audio.getNumChannels(); ++channel)
+    {
+        const auto *rendered = audio.getReadPointer(channel);
+        const auto *expected = reference.getReadPointer(channel);
+
+        for (int sample = 0; sample < audio.getNumSamples(); ++sample)
+        {
+            const auto error = rendered[sample] - expected[sample];
+            result.maximumError = juce::jmax(result.maximumError, std::abs(error));
+            sumOfSquaredErrors += (double) error * error;
+        }
+    }
+
+    const auto rmsError = std::sqrt(sumOfSquaredErrors / ((double) audio.getNumChannels() * audio.getNumSamples()));
+    result.rmsErrorDecibels = juce::Decibels::gainToDecibels(rmsError, -200.0);
+    result.passed = result.maximumError <= scenario.tolerance;
+
+    return result;
+}
+
+// the same oversampled path as the plugin, with a fixed seed so every run is identical
+juce::AudioBuffer<float> RegressionSuite::render(const RegressionScenario &scenario, double &renderSeconds) const
+{
+    auto synthesizer = std::make_unique<Synthesizer>();
+    synthesizer->setWavetable(wavetable);
+    synthesizer->setRandomSeed(REGRESSION_RANDOM_SEED);
+    scenario.configure(*synthesizer);
+
+    OversampledRenderer renderer(*synthesizer);
+    renderer.prepare(REGRESSION_SAMPLE_RATE, REGRESSION_BLOCK_SIZE, REGRESSION_OVERSAMPLING_FACTOR);
+
+    juce::MidiMessageSequence sequence;
+    scenario.createMidi(sequence);
+    sequence.sort();
+
+    const int numSamples = (int) std::ceil(scenario.lengthSeconds * REGRESSION_SAMPLE_RATE);
+    juce::AudioBuffer<float> audio(2, numSamples);
+    juce::AudioBuffer<float> block(2, REGRESSION_BLOCK_SIZE);
+    juce::MidiBuffer midiMessages;
+
+    int nextEventIndex = 0;
+    juce::int64 renderTicks = 0;
+
+    for (int blockStart = 0; blockStart < numSamples; blockStart += REGRESSION_BLOCK_SIZE)
+    {
+        const int blockSize = juce::jmin(REGRESSION_BLOCK_SIZE, numSamples - blockStart);
+        block.setSize(2, blockSize, false, false, true);
+
+        midiMessages.clear();
+        while (nextEventIndex < sequence.getNumEvents())
+        {
+            const auto &message = sequence.getEventPointer(nextEventIndex)->message;
+            const int eventSample = juce::roundToInt(message.getTimeStamp() * REGRESSION_SAMPLE_RATE);
+            if (eventSample >= blockStart + blockSize)
+                break;
+
+            midiMessages.addEvent(message, juce::jmax(0, eventSample - blockStart));
+            ++nextEventIndex;
+        }
+
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+
+        if (scenario.automate)
+            scenario.automate(*synthesizer, blockStart / REGRESSION_SAMPLE_RATE);
+
+        renderer.process(block, midiMessages);
+        renderTicks += juce::Time::getHighResolutionTicks() - startTicks;
+
+        for (int channel = 0; channel < 2; ++channel)
+            audio.copyFrom(channel, blockStart, block, channel, 0, blockSize);
+    }
+
+    renderSeconds = juce::Time::highResolutionTicksToSeconds(renderTicks);
+    return audio;
+}
+
+//================================================================================================
+// REFERENCE AUDIO, stored as 32 bit float wav so the comparison is lossless
+
+bool RegressionSuite::writeReference(const juce::File &file, const juce::AudioBuffer<float> &audio)
+{
+    file.getParentDirectory().createDirectory();
+    file.deleteFile();
+
+    auto outputStream = file.createOutputStream();
+    if (outputStream == nullptr)
+        return false;
+
+    juce::WavAudioFormat wavFormat;
+    std::unique_ptr<juce::AudioFormatWriter> writer(wavFormat.createWriterFor(outputStream.get(), REGRESSION_SAMPLE_RATE, (unsigned int) audio.getNumChannels(), 32, {}, 0));
+    if (writer == nullptr)
+        return false;
+
+    outputStream.release();
+    return writer->writeFromAudioSampleBuffer(audio, 0, audio.getNumSamples());
+}
+
+bool RegressionSuite::readReference(const juce::File &file, juce::AudioBuffer<float> &audio)
+{
+    juce::WavAudioFormat wavFormat;
+    std::unique_ptr<juce::AudioFormatReader> reader(wavFormat.createReaderFor(new juce::FileInputStream(file), true));
+    if (reader == nullptr)
+        return false;
+
+    audio.setSize((int) reader->numChannels, (int) reader->lengthInSamples);
+    return reader->read(&audio, 0, (int) reader->lengthInSamples, 0, true, true);
+}
+
+//================================================================================================
+// REPORT
+
+bool saveRegressionReport(const juce::File &file, const std::vector<RegressionResult> &results)
+{
+    auto *scenarios = new juce::DynamicObject();
+    for (const auto &result : results)
+    {
+        auto *entry = new juce::DynamicObject();
+        entry->setProperty("passed", result.passed);
+        entry->setProperty("referenceMissing", result.referenceMissing);
+        entry->setProperty("maximumError", result.maximumError);
+        entry->setProperty("tolerance", result.tolerance);
+        entry->setProperty("rmsErrorDecibels", result.rmsErrorDecibels);
+        entry->setProperty("nanosecondsPerSample", result.nanosecondsPerSample);
+        entry->setProperty("realtimeFactor", result.realtimeFactor);
+        if (result.error.isNotEmpty())
+            entry->setProperty("error", result.error);
+
+        scenarios->setProperty(result.name, juce::var(entry));
+    }
+
+    auto *report = new juce::DynamicObject();
+    report->setProperty("time", juce::Time::getCurrentTime().toISO8601(true));
+    report->setProperty("scenarios", juce::var(scenarios));
+
+    return file.replaceWithText(juce::JSON::toString(juce::var(report)));
+}
@@ -0,0 +1,84 @@
+#ifndef REGRESSION_SUITE_H
+#define REGRESSION_SUITE_H
+
+#include <JuceHeader.h>
+#include "../../Source/Synthesizer/Synthesizer.h"
+#include "../../Source/Synthesizer/OversampledRenderer.h"
+
+#define REGRESSION_SAMPLE_RATE 48000.0
+#define REGRESSION_BLOCK_SIZE 256
+#define REGRESSION_OVERSAMPLING_FACTOR 4
+#define REGRESSION_RANDOM_SEED 0x5eed
+
+//================================================================================================
+// one fixed midi scenario rendered with a seeded synthesizer
+
+struct RegressionScenario
+{
+    juce::String name;
+    double lengthSeconds;
+
+    // largest sample difference from the reference that still passes
+    float tolerance;
+
+    std::function<void(Synthesizer &)> configure;
+    std::function<void(juce::MidiMessageSequence &)> createMidi;
+
+    // called before every block with the block's start time, may be empty
+    std::function<void(Synthesizer &, double)> automate;
+};
+
+struct RegressionResult
+{
+    juce::String name;
+
+    bool passed = false;
+    bool referenceWritten = false;
+
+    // nothing to compare against yet; not a failed comparison
+    bool referenceMissing = false;
+    juce::String error;
+
+    float maximumError = 0.f;
+    double rmsErrorDecibels = -200.0;
+    float tolerance = 0.f;
+
+    double nanosecondsPerSample = 0.0;
+    double realtimeFactor = 0.0;
+};
+
+//================================================================================================
+// renders every scenario and compares it against stored reference audio, timing each render
+// so an optimisation can be checked for correctness and speed in one run
+
+class RegressionSuite
+{
+public:
+
+    // CONSTRUCTORS / DESTRUCTORS
+    RegressionSuite(const juce::File &referenceDirectory);
+    ~RegressionSuite();
+
+    // SCENARIOS
+    static std::vector<RegressionScenario> createScenarios();
+
+    // RUN, writes the render as the new reference instead of comparing when asked to
+    RegressionResult run(const RegressionScenario &scenario, bool updateReference);
+
+private:
+
+    juce::File referenceDirectory;
+    std::shared_ptr<const Wavetable> wavetable;
+
+    juce::AudioBuffer<float> render(const RegressionScenario &scenario, double &renderSeconds) const;
+
+    static bool writeReference(const juce::File &file, const juce::AudioBuffer<float> &audio);
+    static bool readReference(const juce::File &file, juce::AudioBuffer<float> &audio);
+};
+
+//================================================================================================
+// REPORT, json with the comparison and timing of every scenario
+
+bool saveRegressionReport(const juce::File &file, const std::vector<RegressionResult> &results);
+
+#endif // REGRESSION_SUITE_H
@@ -0,0 +1,159 @@
+#include "SynthesizerBenchmark.h"
+#include "../../Source/Synthesizer/WavetableGenerators.h"
+
+#define BENCHMARK_WARMUP_SECONDS 0.1
+#define BENCHMARK_LOWEST_NOTE 36
+#define BENCHMARK_NOTE_SPACING 3
+
+//================================================================================================
+// BENCHMARK CASE
+
+juce::String BenchmarkCase::getName() const
+{
+    return "poly" + juce::String(polyphony)
+        + "_unison" + juce::String(unisonVoices)
+        + "_block" + juce::String(blockSize)
+        + "_" + juce::String(juce::roundToInt(sampleRate)) + "hz"
+        + "_os" + juce::String(oversamplingFactor) + "x"
+        + (chunkSize == OVERSAMPLED_RENDER_CHUNK_SIZE ? juce::String() : "_chunk" + (chunkSize > 0 ? juce::String(chunkSize) : juce::String("off")))
+        + (numChannels == 1 ? "_mono" : "")
+        + (interpolationMode == InterpolationHermite ? juce::String() : juce::String("_") + getInterpolationModeName(interpolationMode));
+}
+
+//================================================================================================
+// CONSTRUCTORS / DESTRUCTORS
+
+SynthesizerBenchmark::SynthesizerBenchmark(double secondsOfAudio) :
+    secondsOfAudioPerCase(secondsOfAudio)
+{
+    generateSawWavetable(wavetable, 1024);
+}
+
+SynthesizerBenchmark::~SynthesizerBenchmark()
+{
+}
+
+//================================================================================================
+// MATRIX
+
+std::vector<BenchmarkCase> SynthesizerBenchmark::createMatrix(bool quick)
+{
+    const std::vector<int> polyphonies = quick ? std::vector<int>{ 1, MAX_POLYPHONY } : std::vector<int>{ 1, 4, 8, MAX_POLYPHONY };
+    const std::vector<int> unisonCounts = quick ? std::vector<int>{ 1, 8 } : std::vector<int>{ 1, 4, 8, 16, MAX_DETUNE_VOICES };
+    const std::vector<int> blockSizes = quick ? std::vector<int>{ 256 } : std::vector<int>{ 32, 128, 512 };
+    const std::vector<double> sampleRates = quick ? std::vector<double>{ 48000.0 } : std::vector<double>{ 44100.0, 48000.0, 96000.0 };
+    const std::vector<int> oversamplingFactors = quick ? std::vector<int>{ 1, 4 } : std::vector<int>{ 1, 2, 4, 8, 16 };
+
+    std::vector<BenchmarkCase> matrix;
+    for (auto polyphony : polyphonies)
+        for (auto unisonVoices : unisonCounts)
+            for (auto blockSize : blockSizes)
+                for (auto sampleRate : sampleRates)
+                    for (auto oversamplingFactor : oversamplingFactors)
+                        matrix.push_back({ polyphony, unisonVoices, blockSize, sampleRate, oversamplingFactor });
+
+    return matrix;
+}
+
+// eight voices of eight-voice unison at 16x, the case where the oversampled working set
+// of a large host block no longer fits in cache
+std::vector<BenchmarkCase> SynthesizerBenchmark::createBlockSizeSweep()
+{
+    std::vector<BenchmarkCase> sweep;
+    for (auto blockSize : { 32, 64, 128, 256, 512, 1024, 2048, 4096 })
+        for (auto chunkSize : { 0, 64, 128, 256 })
+            sweep.push_back({ 8, 8, blockSize, 48000.0, 16, chunkSize });
+
+    return sweep;
+}
+
+//================================================================================================
+// RUN
+
+BenchmarkResult SynthesizerBenchmark::run(const BenchmarkCase &benchmarkCase)
+{
+    auto synthesizer = std::make_unique<Synthesizer>();
+    synthesizer->setWavetable(wavetable);
+    synthesizer->setDetuneVoices(benchmarkCase.unisonVoices);
+    synthesizer->setDetuneSpread(0.5f);
+    synthesizer->setDetuneMix(1.f);
+    synthesizer->setInterpolationMode(benchmarkCase.interpolationMode);
+    synthesizer->setVolume(0.5f);
+    synthesizer->setAdsrParameters(0.01f, 0.1f, 0.8f, 0.5f);
+
+    OversampledRenderer renderer(*synthesizer);
+    renderer.prepare(benchmarkCase.sampleRate, benchmarkCase.blockSize, benchmarkCase.oversamplingFactor, benchmarkCase.chunkSize, benchmarkCase.numChannels);
+
+    juce::AudioBuffer<float> buffer(benchmarkCase.numChannels, benchmarkCase.blockSize);
+    juce::MidiBuffer midiMessages;
+
+    // hold every note for the whole case so all voices stay in their sustain stage
+    for (int voice = 0; voice < benchmarkCase.polyphony; ++voice)
+    {
+        midiMessages.addEvent(juce::MidiMessage::noteOn(1, BENCHMARK_LOWEST_NOTE + voice * BENCHMARK_NOTE_SPACING, 0.8f), 0);
+    }
+
+    const auto blocksPerSecond = benchmarkCase.sampleRate / benchmarkCase.blockSize;
+    const auto numWarmupBlocks = juce::jmax(1, (int) std::ceil(BENCHMARK_WARMUP_SECONDS * blocksPerSecond));
+    const auto numTimedBlocks = juce::jmax(1, (int) std::ceil(secondsOfAudioPerCase * blocksPerSecond));
+
+    renderBlocks(renderer, buffer, midiMessages, numWarmupBlocks);
+
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+    renderBlocks(renderer, buffer, midiMessages, numTimedBlocks);
+    const auto elapsedSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+
+    const auto numSamples = (double) numTimedBlocks * benchmarkCase.blockSize;
+    const auto audioSeconds = numSamples / benchmarkCase.sampleRate;
+
+    BenchmarkResult result;
+    result.benchmarkCase = benchmarkCase;
+    result.nanosecondsPerSample = elapsedSeconds * 1.0e9 / numSamples;
+    result.realtimeFactor = elapsedSeconds > 0.0 ? audioSeconds / elapsedSeconds : 0.0;
+    result.voicesPerCore = result.realtimeFactor * benchmarkCase.polyphony;
+    return result;
+}
+
+void SynthesizerBenchmark::renderBlocks(OversampledRenderer &renderer, juce::AudioBuffer<float> &buffer, juce::MidiBuffer &midiMessages, int numBlocks)
+{
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        buffer.clear();
+        renderer.process(buffer, midiMessages);
+        midiMessages.clear();
+    }
+}
+
+//================================================================================================
+// BASELINES
+
+bool saveBaseline(const juce::File &file, const std::vector<BenchmarkResult> &results)
+{
+    auto *cases = new juce::DynamicObject();
+    for (const auto &result : results)
+    {
+        cases->setProperty(result.benchmarkCase.getName(), result.nanosecondsPerSample);
+    }
+
+    auto *baseline = new juce::DynamicObject();
+    baseline->setProperty("unit", "ns/sample");
+    baseline->setProperty("cases", juce::var(cases));
+
+    return file.replaceWithText(juce::JSON::toString(juce::var(baseline)));
+}
+
+std::map<juce::String, double> loadBaseline(const juce::File &file)
+{
+    std::map<juce::String, double> baseline;
+
+    auto parsed = juce::JSON::parse(file);
+    if (auto *cases = parsed.getProperty("cases", {}).getDynamicObject())
+    {
+        for (const auto &property : cases->getProperties())
+        {
+            baseline[property.name.toString()] = (double) property.value;
+        }
+    }
+
+    return baseline;
+}
@@ -0,0 +1,69 @@
+#ifndef SYNTHESIZER_BENCHMARK_H
+#define SYNTHESIZER_BENCHMARK_H
+
+#include <JuceHeader.h>
+#include "../../Source/Synthesizer/Synthesizer.h"
+#include "../../Source/Synthesizer/OversampledRenderer.h"
+
+//================================================================================================
+// one point of the benchmark matrix
+
+struct BenchmarkCase
+{
+    int polyphony;
+    int unisonVoices;
+    int blockSize;
+    double sampleRate;
+    int oversamplingFactor;
+    int chunkSize = OVERSAMPLED_RENDER_CHUNK_SIZE;
+    int numChannels = 2;
+    int interpolationMode = InterpolationHermite;
+
+    juce::String getName() const;
+};
+
+struct BenchmarkResult
+{
+    BenchmarkCase benchmarkCase;
+
+    double nanosecondsPerSample;
+    double realtimeFactor;
+    double voicesPerCore;
+};
+
+//================================================================================================
+// renders Synthesizer::processBlock through the same oversampling path as the plugin
+// and times it on the calling thread
+
+class SynthesizerBenchmark
+{
+public:
+
+    // CONSTRUCTORS / DESTRUCTORS
+    SynthesizerBenchmark(double secondsOfAudioPerCase);
+    ~SynthesizerBenchmark();
+
+    // MATRIX
+    static std::vector<BenchmarkCase> createMatrix(bool quick);
+
+    // throughput against host block size, with and without internal chunking
+    static std::vector<BenchmarkCase> createBlockSizeSweep();
+
+    // RUN
+    BenchmarkResult run(const BenchmarkCase &benchmarkCase);
+
+private:
+
+    Wavetable wavetable;
+    double secondsOfAudioPerCase;
+
+    static void renderBlocks(OversampledRenderer &renderer, juce::AudioBuffer<float> &buffer, juce::MidiBuffer &midiMessages, int numBlocks);
+};
+
+//================================================================================================
+// BASELINES, stored as json keyed by case name
+
+bool saveBaseline(const juce::File &file, const std::vector<BenchmarkResult> &results);
+std::map<juce::String, double> loadBaseline(const juce::File &file);
+
+#endif // SYNTHESIZER_BENCHMARK_H
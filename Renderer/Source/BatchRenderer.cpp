@@ -0,0 +1,173 @@
+#include <numeric>
+#include "BatchRenderer.h"
+
+//================================================================================================
+// BATCH ZONE
+
+juce::String BatchZone::getFileName() const
+{
+    return "note" + juce::String(note).paddedLeft('0', 3)
+        + "_vel" + juce::String(velocity).paddedLeft('0', 3)
+        + "_" + juce::String(juce::roundToInt(durationSeconds * 1000.0)) + "ms.wav";
+}
+
+//================================================================================================
+// CONSTRUCTORS / DESTRUCTORS
+
+BatchRenderer::BatchRenderer(const OfflineRenderSettings &settingsToUse, const SynthesizerState &stateToUse, std::shared_ptr<const Wavetable> wavetableToShare) :
+    settings(settingsToUse),
+    state(stateToUse),
+    wavetable(std::move(wavetableToShare))
+{
+}
+
+BatchRenderer::~BatchRenderer()
+{
+}
+
+//================================================================================================
+// GRID
+
+std::vector<BatchZone> BatchRenderer::createGrid(const std::vector<int> &notes, const std::vector<int> &velocities, const std::vector<double> &durations)
+{
+    std::vector<BatchZone> zones;
+
+    for (size_t noteIndex = 0; noteIndex < notes.size(); ++noteIndex)
+    {
+        for (size_t velocityIndex = 0; velocityIndex < velocities.size(); ++velocityIndex)
+        {
+            for (auto duration : durations)
+            {
+                BatchZone zone{ notes[noteIndex], velocities[velocityIndex], duration };
+
+                // keys are split halfway to the neighbouring samples, velocity layers
+                // play from just above the layer below up to their own velocity
+                zone.lowNote = noteIndex == 0 ? 0 : (notes[noteIndex - 1] + notes[noteIndex]) / 2 + 1;
+                zone.highNote = noteIndex + 1 == notes.size() ? 127 : (notes[noteIndex] + notes[noteIndex + 1]) / 2;
+                zone.lowVelocity = velocityIndex == 0 ? 1 : velocities[velocityIndex - 1] + 1;
+                zone.highVelocity = velocityIndex + 1 == velocities.size() ? 127 : velocities[velocityIndex];
+
+                zones.push_back(zone);
+            }
+        }
+    }
+
+    return zones;
+}
+
+//================================================================================================
+// RENDER
+
+BatchResult BatchRenderer::render(const std::vector<BatchZone> &zones, const juce::File &outputDirectory, int numThreads)
+{
+    BatchResult result;
+    result.numZones = (int) zones.size();
+    result.numThreads = juce::jmax(1, numThreads);
+
+    zoneResults.assign(zones.size(), {});
+    outputDirectory.createDirectory();
+
+    // longest zones first so the last jobs to finish are short ones and no core idles
+    // while a single long render completes
+    std::vector<size_t> order(zones.size());
+    std::iota(order.begin(), order.end(), (size_t) 0);
+    std::stable_sort(order.begin(), order.end(), [&zones](size_t a, size_t b) { return zones[a].durationSeconds > zones[b].durationSeconds; });
+
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+
+    {
+        juce::ThreadPool threadPool(result.numThreads);
+        juce::WaitableEvent allZonesRendered;
+        std::atomic<int> numZonesRemaining{ (int) zones.size() };
+
+        for (auto zoneIndex : order)
+        {
+            threadPool.addJob([this, &zones, &outputDirectory, &allZonesRendered, &numZonesRemaining, zoneIndex]
+            {
+                renderZone(zones[zoneIndex], outputDirectory, zoneResults[zoneIndex]);
+
+                if (numZonesRemaining.fetch_sub(1) == 1)
+                    allZonesRendered.signal();
+            });
+        }
+
+        if (!zones.empty())
+            allZonesRendered.wait();
+    }
+
+    result.wallSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+
+    double summedZoneSeconds = 0.0;
+    for (const auto &zoneResult : zoneResults)
+    {
+        if (zoneResult.error.isNotEmpty())
+            ++result.numFailed;
+
+        result.audioSeconds += zoneResult.render.audioSeconds;
+        summedZoneSeconds += zoneResult.render.totalSeconds;
+    }
+
+    result.speedup = result.wallSeconds > 0.0 ? summedZoneSeconds / result.wallSeconds : 0.0;
+
+    if (!writeManifest(zones, outputDirectory))
+        ++result.numFailed;
+
+    return result;
+}
+
+const std::vector<BatchZoneResult> &BatchRenderer::getZoneResults() const
+{
+    return zoneResults;
+}
+
+// runs on a pool thread; everything mutable is local to the job
+void BatchRenderer::renderZone(const BatchZone &zone, const juce::File &outputDirectory, BatchZoneResult &result) const
+{
+    juce::MidiMessageSequence sequence;
+    sequence.addEvent(juce::MidiMessage::noteOn(1, zone.note, (juce::uint8) zone.velocity), 0.0);
+    sequence.addEvent(juce::MidiMessage::noteOff(1, zone.note), zone.durationSeconds);
+
+    auto renderer = std::make_unique<OfflineRenderer>(settings, wavetable);
+    renderer->setState(state);
+    renderer->setMidiSequence(sequence);
+
+    result.error = renderer->render(outputDirectory.getChildFile(zone.getFileName()), result.render);
+}
+
+//================================================================================================
+// MANIFEST
+
+bool BatchRenderer::writeManifest(const std::vector<BatchZone> &zones, const juce::File &outputDirectory) const
+{
+    juce::Array<juce::var> zoneList;
+
+    for (size_t zoneIndex = 0; zoneIndex < zones.size(); ++zoneIndex)
+    {
+        const auto &zone = zones[zoneIndex];
+        const auto &zoneResult = zoneResults[zoneIndex];
+
+        if (zoneResult.error.isNotEmpty())
+            continue;
+
+        auto *entry = new juce::DynamicObject();
+        entry->setProperty("file", zone.getFileName());
+        entry->setProperty("rootNote", zone.note);
+        entry->setProperty("lowNote", zone.lowNote);
+        entry->setProperty("highNote", zone.highNote);
+        entry->setProperty("velocity", zone.velocity);
+        entry->setProperty("lowVelocity", zone.lowVelocity);
+        entry->setProperty("highVelocity", zone.highVelocity);
+        entry->setProperty("heldSeconds", zone.durationSeconds);
+        entry->setProperty("lengthInSamples", zoneResult.render.numSamples);
+        zoneList.add(juce::var(entry));
+    }
+
+    auto *manifest = new juce::DynamicObject();
+    manifest->setProperty("sampleRate", settings.sampleRate);
+    manifest->setProperty("bitDepth", settings.bitDepth);
+    manifest->setProperty("oversamplingFactor", settings.oversamplingFactor);
+    manifest->setProperty("interpolation", juce::String(getInterpolationModeName(settings.interpolationMode)));
+    manifest->setProperty("zones", zoneList);
+
+    return outputDirectory.getChildFile("manifest.json").replaceWithText(juce::JSON::toString(juce::var(manifest)));
+}
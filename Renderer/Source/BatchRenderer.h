@@ -0,0 +1,76 @@
+#ifndef BATCH_RENDERER_H
+#define BATCH_RENDERER_H
+
+#include <JuceHeader.h>
+#include "OfflineRenderer.h"
+
+//================================================================================================
+// one sample of a multi-sampled instrument: a single held note
+
+struct BatchZone
+{
+    int note;
+    int velocity;
+    double durationSeconds;
+
+    // key and velocity range the zone covers in the manifest
+    int lowNote = 0;
+    int highNote = 127;
+    int lowVelocity = 1;
+    int highVelocity = 127;
+
+    juce::String getFileName() const;
+};
+
+struct BatchZoneResult
+{
+    OfflineRenderResult render;
+    juce::String error;
+};
+
+struct BatchResult
+{
+    int numZones = 0;
+    int numFailed = 0;
+    int numThreads = 0;
+
+    double audioSeconds = 0.0;
+    double wallSeconds = 0.0;
+
+    // summed single-zone render time over wall time, ideally close to numThreads
+    double speedup = 0.0;
+};
+
+//================================================================================================
+// renders a note x velocity x duration grid on a thread pool; every zone gets its own
+// Synthesizer, and all of them read the same immutable wavetable
+
+class BatchRenderer
+{
+public:
+
+    // CONSTRUCTORS / DESTRUCTORS
+    BatchRenderer(const OfflineRenderSettings &settings, const SynthesizerState &state, std::shared_ptr<const Wavetable> wavetable);
+    ~BatchRenderer();
+
+    // GRID, each list sorted ascending; key and velocity ranges are split between neighbours
+    static std::vector<BatchZone> createGrid(const std::vector<int> &notes, const std::vector<int> &velocities, const std::vector<double> &durations);
+
+    // RENDER, writes one wav per zone and a manifest.json into the output directory
+    BatchResult render(const std::vector<BatchZone> &zones, const juce::File &outputDirectory, int numThreads);
+
+    const std::vector<BatchZoneResult> &getZoneResults() const;
+
+private:
+
+    OfflineRenderSettings settings;
+    SynthesizerState state;
+    std::shared_ptr<const Wavetable> wavetable;
+
+    std::vector<BatchZoneResult> zoneResults;
+
+    void renderZone(const BatchZone &zone, const juce::File &outputDirectory, BatchZoneResult &result) const;
+    bool writeManifest(const std::vector<BatchZone> &zones, const juce::File &outputDirectory) const;
+};
+
+#endif // BATCH_RENDERER_H
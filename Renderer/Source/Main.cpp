@@ -0,0 +1,193 @@
+/*
+  ==============================================================================
+
+    Offline MIDI to WAV rendering through the synthesizer.
+
+    usage: WavetableSynthRenderer --midi <file> --output <file> [--state <file>]
+                                  [--sample-rate <hz>] [--bit-depth <16|24|32>]
+                                  [--oversampling <1..16>] [--block-size <n>]
+                                  [--interpolator <mode>] [--tail <seconds>] [--seed <n>]
+           WavetableSynthRenderer --batch <directory> [--state <file>]
+                                  [--notes <low:high:step | list>] [--velocities <list>]
+                                  [--durations <seconds list>] [--threads <n>]
+                                  [any of the render options above]
+
+  ==============================================================================
+*/
+
+#include <iostream>
+#include <JuceHeader.h>
+#include "OfflineRenderer.h"
+#include "BatchRenderer.h"
+
+//==============================================================================
+static void printUsage()
+{
+    std::cerr << "usage: WavetableSynthRenderer --midi <file> --output <file> [--state <file>]" << std::endl
+              << "                              [--sample-rate <hz>] [--bit-depth <16|24|32>]" << std::endl
+              << "                              [--oversampling <1..16>] [--block-size <n>]" << std::endl
+              << "                              [--interpolator <mode>] [--tail <seconds>] [--seed <n>]" << std::endl
+              << "       WavetableSynthRenderer --batch <directory> [--state <file>]" << std::endl
+              << "                              [--notes <low:high:step | list>] [--velocities <list>]" << std::endl
+              << "                              [--durations <seconds list>] [--threads <n>]" << std::endl;
+}
+
+static OfflineRenderSettings getSettingsFromArguments(const juce::ArgumentList &arguments)
+{
+    OfflineRenderSettings settings;
+
+    if (arguments.containsOption("--sample-rate"))
+        settings.sampleRate = juce::jlimit(8000.0, 384000.0, arguments.getValueForOption("--sample-rate").getDoubleValue());
+
+    if (arguments.containsOption("--bit-depth"))
+        settings.bitDepth = arguments.getValueForOption("--bit-depth").getIntValue();
+
+    if (arguments.containsOption("--oversampling"))
+        settings.oversamplingFactor = juce::jlimit(1, MAX_OVERSAMPLING_FACTOR, arguments.getValueForOption("--oversampling").getIntValue());
+
+    if (arguments.containsOption("--block-size"))
+        settings.blockSize = juce::jlimit(16, 8192, arguments.getValueForOption("--block-size").getIntValue());
+
+    // linear, hermite, hermite6, sinc8, sinc16 or sinc32; unknown names keep the default
+    if (arguments.containsOption("--interpolator"))
+        settings.interpolationMode = parseInterpolationMode(arguments.getValueForOption("--interpolator"), settings.interpolationMode);
+
+    if (arguments.containsOption("--tail"))
+        settings.tailSeconds = juce::jmax(0.0, arguments.getValueForOption("--tail").getDoubleValue());
+
+    if (arguments.containsOption("--seed"))
+        settings.randomSeed = juce::jmax((juce::int64) 0, arguments.getValueForOption("--seed").getLargeIntValue());
+
+    return settings;
+}
+
+// "36:96:12" expands to a stepped range, anything else is read as a comma separated list
+static std::vector<double> parseValueList(const juce::String &text)
+{
+    std::vector<double> values;
+
+    auto rangeTokens = juce::StringArray::fromTokens(text, ":", "");
+    if (rangeTokens.size() == 3)
+    {
+        const auto step = juce::jmax(1.0, rangeTokens[2].getDoubleValue());
+        for (auto value = rangeTokens[0].getDoubleValue(); value <= rangeTokens[1].getDoubleValue(); value += step)
+            values.push_back(value);
+    }
+    else
+    {
+        for (const auto &token : juce::StringArray::fromTokens(text, ",", ""))
+            if (token.trim().isNotEmpty())
+                values.push_back(token.getDoubleValue());
+    }
+
+    std::sort(values.begin(), values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+    return values;
+}
+
+static std::vector<int> parseMidiValueList(const juce::String &text, int lowest)
+{
+    std::vector<int> values;
+    for (auto value : parseValueList(text))
+        values.push_back(juce::jlimit(lowest, 127, juce::roundToInt(value)));
+
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+    return values;
+}
+
+static int runBatch(const juce::ArgumentList &arguments)
+{
+    SynthesizerState state;
+    if (arguments.containsOption("--state"))
+    {
+        auto error = OfflineRenderer::loadStateFile(arguments.getFileForOption("--state"), state);
+        if (error.isNotEmpty())
+        {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+    }
+
+    auto optionOrDefault = [&arguments](const juce::String &option, const juce::String &defaultValue)
+    {
+        return arguments.containsOption(option) ? arguments.getValueForOption(option) : defaultValue;
+    };
+
+    const auto notes = parseMidiValueList(optionOrDefault("--notes", "24:96:3"), 0);
+    const auto velocities = parseMidiValueList(optionOrDefault("--velocities", "32,64,96,127"), 1);
+
+    std::vector<double> durations;
+    for (auto duration : parseValueList(optionOrDefault("--durations", "2")))
+        if (duration > 0.0)
+            durations.push_back(duration);
+
+    const auto zones = BatchRenderer::createGrid(notes, velocities, durations);
+    if (zones.empty())
+    {
+        std::cerr << "the note, velocity and duration lists leave no zones to render" << std::endl;
+        return 1;
+    }
+
+    const int numThreads = juce::jmax(1, optionOrDefault("--threads", juce::String(juce::SystemStats::getNumCpus())).getIntValue());
+    auto outputDirectory = arguments.getFileForOption("--batch");
+
+    // one wavetable for the whole batch, read concurrently by every zone's synthesizer
+    BatchRenderer batchRenderer(getSettingsFromArguments(arguments), state, OfflineRenderer::createDefaultWavetable());
+    const auto result = batchRenderer.render(zones, outputDirectory, numThreads);
+
+    const auto &zoneResults = batchRenderer.getZoneResults();
+    for (size_t zoneIndex = 0; zoneIndex < zones.size(); ++zoneIndex)
+        if (zoneResults[zoneIndex].error.isNotEmpty())
+            std::cerr << zones[zoneIndex].getFileName() << ": " << zoneResults[zoneIndex].error << std::endl;
+
+    std::cout << "rendered " << (result.numZones - result.numFailed) << " of " << result.numZones << " zones, "
+              << juce::String(result.audioSeconds, 1) << " s of audio to " << outputDirectory.getFullPathName() << std::endl
+              << "wall time: " << juce::String(result.wallSeconds, 3) << " s, "
+              << juce::String(result.wallSeconds > 0.0 ? result.audioSeconds / result.wallSeconds : 0.0, 1) << "x realtime" << std::endl
+              << "speedup:   " << juce::String(result.speedup, 2) << "x on " << result.numThreads << " threads" << std::endl;
+
+    return result.numFailed == 0 ? 0 : 1;
+}
+
+int main (int argc, char* argv[])
+{
+    juce::ArgumentList arguments(argc, argv);
+
+    if (arguments.containsOption("--batch"))
+        return runBatch(arguments);
+
+    if (!arguments.containsOption("--midi") || !arguments.containsOption("--output"))
+    {
+        printUsage();
+        return 1;
+    }
+
+    const auto settings = getSettingsFromArguments(arguments);
+    auto renderer = std::make_unique<OfflineRenderer>(settings, OfflineRenderer::createDefaultWavetable());
+
+    auto midiFile = arguments.getFileForOption("--midi");
+    auto error = renderer->loadMidi(midiFile);
+
+    if (error.isEmpty() && arguments.containsOption("--state"))
+        error = renderer->loadState(arguments.getFileForOption("--state"));
+
+    OfflineRenderResult result;
+    auto outputFile = arguments.getFileForOption("--output");
+
+    if (error.isEmpty())
+        error = renderer->render(outputFile, result);
+
+    if (error.isNotEmpty())
+    {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+
+    std::cout << "rendered " << juce::String(result.audioSeconds, 2) << " s of audio to " << outputFile.getFullPathName() << std::endl
+              << "synthesizer: " << juce::String(result.renderSeconds, 3) << " s, "
+              << juce::String(result.realtimeFactor, 1) << "x realtime" << std::endl
+              << "total:       " << juce::String(result.totalSeconds, 3) << " s, "
+              << juce::String(result.totalRealtimeFactor, 1) << "x realtime" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,182 @@
+#include "OfflineRenderer.h"
+#include "../../Source/Synthesizer/WavetableGenerators.h"
+
+#define OFFLINE_RENDER_MINIMUM_TAIL_SECONDS 0.1
+
+//================================================================================================
+// CONSTRUCTORS / DESTRUCTORS
+
+OfflineRenderer::OfflineRenderer(const OfflineRenderSettings &settingsToUse, std::shared_ptr<const Wavetable> wavetable) :
+    settings(settingsToUse)
+{
+    synthesizer.setWavetable(std::move(wavetable));
+
+    if (settings.randomSeed >= 0)
+        synthesizer.setRandomSeed(settings.randomSeed);
+}
+
+OfflineRenderer::~OfflineRenderer()
+{
+}
+
+std::shared_ptr<const Wavetable> OfflineRenderer::createDefaultWavetable()
+{
+    Wavetable wavetable;
+    generateSawWavetable(wavetable, 1024);
+    return std::make_shared<const Wavetable>(std::move(wavetable));
+}
+
+//================================================================================================
+// INPUT
+
+// accepts the binary blob written by getStateInformation, or the same tree saved as xml
+juce::String OfflineRenderer::loadStateFile(const juce::File &stateFile, SynthesizerState &stateToFill)
+{
+    juce::MemoryBlock stateData;
+    if (!stateFile.loadFileAsData(stateData))
+        return "could not read state file " + stateFile.getFullPathName();
+
+    auto parameterTree = juce::ValueTree::readFromData(stateData.getData(), stateData.getSize());
+    if (!parameterTree.isValid())
+        parameterTree = juce::ValueTree::fromXml(stateData.toString());
+
+    if (!parameterTree.isValid())
+        return stateFile.getFullPathName() + " is not a WavetableSynth state file";
+
+    stateToFill = getSynthesizerStateFromParameterTree(parameterTree);
+    return {};
+}
+
+juce::String OfflineRenderer::loadState(const juce::File &stateFile)
+{
+    return loadStateFile(stateFile, state);
+}
+
+// merges every track into one sequence with timestamps in seconds
+juce::String OfflineRenderer::loadMidi(const juce::File &midiFileToLoad)
+{
+    juce::FileInputStream input(midiFileToLoad);
+    if (!input.openedOk())
+        return "could not open midi file " + midiFileToLoad.getFullPathName();
+
+    juce::MidiFile midiFile;
+    if (!midiFile.readFrom(input))
+        return midiFileToLoad.getFullPathName() + " is not a standard midi file";
+
+    midiFile.convertTimestampTicksToSeconds();
+
+    sequence.clear();
+    for (int track = 0; track < midiFile.getNumTracks(); ++track)
+    {
+        sequence.addSequence(*midiFile.getTrack(track), 0.0);
+    }
+
+    // tempo, names and other meta events mean nothing to the synthesizer
+    for (int eventIndex = sequence.getNumEvents() - 1; eventIndex >= 0; --eventIndex)
+    {
+        if (sequence.getEventPointer(eventIndex)->message.isMetaEvent())
+            sequence.deleteEvent(eventIndex, false);
+    }
+
+    return {};
+}
+
+void OfflineRenderer::setState(const SynthesizerState &newState)
+{
+    state = newState;
+}
+
+void OfflineRenderer::setMidiSequence(const juce::MidiMessageSequence &newSequence)
+{
+    sequence = newSequence;
+}
+
+//================================================================================================
+// RENDER
+
+juce::String OfflineRenderer::render(const juce::File &outputFile, OfflineRenderResult &result)
+{
+    const auto totalStartTicks = juce::Time::getHighResolutionTicks();
+
+    oversampledRenderer.prepare(settings.sampleRate, settings.blockSize, settings.oversamplingFactor);
+    applySynthesizerState(synthesizer, state);
+    synthesizer.setInterpolationMode(settings.interpolationMode);
+
+    outputFile.deleteFile();
+    auto outputStream = outputFile.createOutputStream();
+    if (outputStream == nullptr)
+        return "could not create " + outputFile.getFullPathName();
+
+    juce::WavAudioFormat wavFormat;
+    std::unique_ptr<juce::AudioFormatWriter> writer(wavFormat.createWriterFor(outputStream.get(), settings.sampleRate, 2, settings.bitDepth, {}, 0));
+    if (writer == nullptr)
+        return "could not write a " + juce::String(settings.bitDepth) + " bit wav at " + juce::String(settings.sampleRate) + " Hz";
+
+    // the writer owns the stream from here on
+    outputStream.release();
+
+    // render past the end by the oversampling latency and drop that much from the start,
+    // so the file lines up with the midi sample for sample
+    const int latency = juce::roundToInt(oversampledRenderer.getLatencyInSamples());
+    const auto lengthInSamples = getLengthInSamples();
+    const auto numSamplesToRender = lengthInSamples + latency;
+
+    juce::AudioBuffer<float> buffer(2, settings.blockSize);
+    juce::MidiBuffer midiMessages;
+    int nextEventIndex = 0;
+    juce::int64 renderTicks = 0;
+
+    for (juce::int64 blockStart = 0; blockStart < numSamplesToRender; blockStart += settings.blockSize)
+    {
+        const int numSamples = (int) juce::jmin((juce::int64) settings.blockSize, numSamplesToRender - blockStart);
+        buffer.setSize(2, numSamples, false, false, true);
+        fillBlockMidi(midiMessages, nextEventIndex, blockStart, numSamples);
+
+        const auto blockStartTicks = juce::Time::getHighResolutionTicks();
+        oversampledRenderer.process(buffer, midiMessages);
+        renderTicks += juce::Time::getHighResolutionTicks() - blockStartTicks;
+
+        const int numLatencySamples = (int) juce::jlimit((juce::int64) 0, (juce::int64) numSamples, latency - blockStart);
+        if (!writer->writeFromAudioSampleBuffer(buffer, numLatencySamples, numSamples - numLatencySamples))
+            return "could not write to " + outputFile.getFullPathName();
+    }
+
+    writer.reset();
+
+    result.numSamples = lengthInSamples;
+    result.audioSeconds = (double) lengthInSamples / settings.sampleRate;
+    result.renderSeconds = juce::Time::highResolutionTicksToSeconds(renderTicks);
+    result.totalSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - totalStartTicks);
+    result.realtimeFactor = result.renderSeconds > 0.0 ? result.audioSeconds / result.renderSeconds : 0.0;
+    result.totalRealtimeFactor = result.totalSeconds > 0.0 ? result.audioSeconds / result.totalSeconds : 0.0;
+
+    return {};
+}
+
+// last event plus enough tail for the final release to finish
+juce::int64 OfflineRenderer::getLengthInSamples() const
+{
+    const auto tailSeconds = settings.tailSeconds >= 0.0 ? settings.tailSeconds
+                                                         : state.adsrRelease + OFFLINE_RENDER_MINIMUM_TAIL_SECONDS;
+
+    const auto lengthSeconds = sequence.getEndTime() + tailSeconds;
+    return juce::jmax((juce::int64) 1, (juce::int64) std::ceil(lengthSeconds * settings.sampleRate));
+}
+
+// collect the events that fall inside this block, positioned relative to its start
+void OfflineRenderer::fillBlockMidi(juce::MidiBuffer &midiMessages, int &nextEventIndex, juce::int64 blockStart, int numSamples) const
+{
+    midiMessages.clear();
+
+    while (nextEventIndex < sequence.getNumEvents())
+    {
+        const auto &message = sequence.getEventPointer(nextEventIndex)->message;
+        const auto eventSample = (juce::int64) std::llround(message.getTimeStamp() * settings.sampleRate);
+
+        if (eventSample >= blockStart + numSamples)
+            break;
+
+        midiMessages.addEvent(message, (int) juce::jmax((juce::int64) 0, eventSample - blockStart));
+        ++nextEventIndex;
+    }
+}
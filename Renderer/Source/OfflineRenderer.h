@@ -0,0 +1,82 @@
+#ifndef OFFLINE_RENDERER_H
+#define OFFLINE_RENDERER_H
+
+#include <JuceHeader.h>
+#include "../../Source/Synthesizer/Synthesizer.h"
+#include "../../Source/Synthesizer/SynthesizerState.h"
+#include "../../Source/Synthesizer/OversampledRenderer.h"
+
+//================================================================================================
+// render configuration, defaulting to the highest quality the dsp code supports
+
+struct OfflineRenderSettings
+{
+    double sampleRate = 48000.0;
+    int bitDepth = 24;
+    int blockSize = 1024;
+    int oversamplingFactor = MAX_OVERSAMPLING_FACTOR;
+
+    // replaces the state's interpolation mode, as the plugin does when the host bounces
+    int interpolationMode = OFFLINE_INTERPOLATION_MODE;
+
+    // seconds rendered after the last midi event, negative to follow the release time
+    double tailSeconds = -1.0;
+
+    // seed for the unison phases, negative for different phases on every run
+    juce::int64 randomSeed = -1;
+};
+
+struct OfflineRenderResult
+{
+    juce::int64 numSamples = 0;
+
+    double audioSeconds = 0.0;
+    double renderSeconds = 0.0;
+    double totalSeconds = 0.0;
+
+    // audio seconds per second spent in the synthesizer, and including file output
+    double realtimeFactor = 0.0;
+    double totalRealtimeFactor = 0.0;
+};
+
+//================================================================================================
+// renders a midi file through the plugin's synthesizer and oversampling path into a wav file,
+// as fast as the calling thread allows
+
+class OfflineRenderer
+{
+public:
+
+    // CONSTRUCTORS / DESTRUCTORS
+    OfflineRenderer(const OfflineRenderSettings &settings, std::shared_ptr<const Wavetable> wavetable);
+    ~OfflineRenderer();
+
+    // the table the plugin loads on construction
+    static std::shared_ptr<const Wavetable> createDefaultWavetable();
+
+    // INPUT, loaders return an error message or an empty string
+    static juce::String loadStateFile(const juce::File &stateFile, SynthesizerState &stateToFill);
+    juce::String loadState(const juce::File &stateFile);
+    juce::String loadMidi(const juce::File &midiFile);
+
+    void setState(const SynthesizerState &newState);
+    void setMidiSequence(const juce::MidiMessageSequence &newSequence);
+
+    // RENDER
+    juce::String render(const juce::File &outputFile, OfflineRenderResult &result);
+
+private:
+
+    OfflineRenderSettings settings;
+
+    Synthesizer synthesizer;
+    OversampledRenderer oversampledRenderer{ synthesizer };
+    SynthesizerState state;
+
+    juce::MidiMessageSequence sequence;
+
+    juce::int64 getLengthInSamples() const;
+    void fillBlockMidi(juce::MidiBuffer &midiMessages, int &nextEventIndex, juce::int64 blockStart, int numSamples) const;
+};
+
+#endif // OFFLINE_RENDERER_H
@@ -0,0 +1,225 @@
+#include "AnalyzerDisplay.h"
+
+#define ANALYZER_SCOPE_SIZE 512
+#define ANALYZER_MIN_DECIBELS -96.f
+#define ANALYZER_MIN_FREQUENCY 20.f
+
+//================================================================================================
+// CONSTRUCTORS / DESTRUCTORS
+
+AnalyzerDisplayComponent::AnalyzerDisplayComponent(WavetableSynthAudioProcessor &p) :
+    audioProcessor(p)
+{
+    incomingSamples.resize(ANALYZER_FFT_SIZE, 0.f);
+    history.resize(ANALYZER_HISTORY_SIZE, 0.f);
+    scopeSamples.resize(ANALYZER_SCOPE_SIZE, 0.f);
+    fftData.resize(2 * ANALYZER_FFT_SIZE, 0.f);
+    spectrumLevels.resize(ANALYZER_FFT_SIZE / 2 + 1, ANALYZER_MIN_DECIBELS);
+}
+
+AnalyzerDisplayComponent::~AnalyzerDisplayComponent()
+{
+}
+
+//================================================================================================
+// COMPONENT OVERRIDES
+
+void AnalyzerDisplayComponent::paint(juce::Graphics &g)
+{
+    using namespace juce;
+
+    //------------------------------------------------------------------------
+    // PAINT BACKGROUND
+    g.fillAll(Colour(SCREEN_MAIN_COLOR_HEX));
+
+    //------------------------------------------------------------------------
+    // PAINT SCOPE AND SPECTRUM
+
+    auto bounds = getLocalBounds().toFloat().reduced(5.f);
+    auto scopeArea = bounds.removeFromTop(bounds.getHeight() / 2);
+    auto spectrumArea = bounds;
+
+    paintScope(g, scopeArea);
+    paintSpectrum(g, spectrumArea);
+
+    // divider
+    g.setColour(Colour(BORDER_COLOR_HEX));
+    g.drawLine(spectrumArea.getX(), spectrumArea.getY(), spectrumArea.getRight(), spectrumArea.getY(), 2.f);
+
+    //------------------------------------------------------------------------
+    // PAINT BORDER
+
+    auto border = getLocalBounds().toFloat();
+    g.setColour(Colour(BORDER_COLOR_HEX));
+    g.drawRect(border, 5.f);
+}
+
+// only analyse while the view is on screen
+void AnalyzerDisplayComponent::visibilityChanged()
+{
+    if (isVisible())
+    {
+        startTimerHz(ANALYZER_FRAME_RATE_HZ);
+    }
+    else
+    {
+        stopTimer();
+    }
+}
+
+//================================================================================================
+// TIMER CAPS THE ANALYSIS RATE
+
+void AnalyzerDisplayComponent::timerCallback()
+{
+    if (!pullSamples())
+        return;
+
+    updateScope();
+    updateSpectrum();
+    repaint();
+}
+
+//================================================================================================
+// SAMPLE HISTORY
+
+// drain the fifo into the history ring; returns false if nothing new arrived
+bool AnalyzerDisplayComponent::pullSamples()
+{
+    auto &fifo = audioProcessor.getAnalyzerFifo();
+    bool receivedSamples = false;
+
+    int numPopped;
+    while ((numPopped = fifo.pop(incomingSamples.data(), (int) incomingSamples.size())) > 0)
+    {
+        for (int i = 0; i < numPopped; ++i)
+        {
+            history[(size_t) historyWritePosition] = incomingSamples[(size_t) i];
+            historyWritePosition = (historyWritePosition + 1) % ANALYZER_HISTORY_SIZE;
+        }
+        receivedSamples = true;
+    }
+
+    return receivedSamples;
+}
+
+float AnalyzerDisplayComponent::getHistorySample(int samplesAgo) const
+{
+    auto index = (historyWritePosition - 1 - samplesAgo + 2 * ANALYZER_HISTORY_SIZE) % ANALYZER_HISTORY_SIZE;
+    return history[(size_t) index];
+}
+
+//================================================================================================
+// OSCILLOSCOPE
+
+// most recent rising zero crossing that still leaves a full window after it,
+// or a free-running window if the signal never crosses zero
+int AnalyzerDisplayComponent::findTriggerSamplesAgo(int windowSize) const
+{
+    for (int samplesAgo = windowSize; samplesAgo < ANALYZER_HISTORY_SIZE - 1; ++samplesAgo)
+    {
+        if (getHistorySample(samplesAgo + 1) <= 0.f && getHistorySample(samplesAgo) > 0.f)
+            return samplesAgo;
+    }
+
+    return windowSize;
+}
+
+void AnalyzerDisplayComponent::updateScope()
+{
+    const int triggerSamplesAgo = findTriggerSamplesAgo(ANALYZER_SCOPE_SIZE);
+
+    for (int i = 0; i < ANALYZER_SCOPE_SIZE; ++i)
+    {
+        scopeSamples[(size_t) i] = getHistorySample(triggerSamplesAgo - i);
+    }
+}
+
+void AnalyzerDisplayComponent::paintScope(juce::Graphics &g, juce::Rectangle<float> area)
+{
+    using namespace juce;
+
+    // draw 0 line
+    g.setColour(Colour(0xFF97C6AE));
+    g.drawLine(area.getX(), area.getCentreY(), area.getRight(), area.getCentreY(), 1.5f);
+
+    // draw waveform
+    Path scopePath;
+    scopePath.preallocateSpace(3 * ANALYZER_SCOPE_SIZE);
+
+    for (int i = 0; i < ANALYZER_SCOPE_SIZE; ++i)
+    {
+        auto pixelCoordX = area.getX() + area.getWidth() * (float) i / (float) (ANALYZER_SCOPE_SIZE - 1);
+        auto sampleValue = jlimit(-1.f, 1.f, scopeSamples[(size_t) i]);
+        auto pixelCoordY = jmap(sampleValue, -1.f, 1.f, area.getBottom(), area.getY());
+
+        if (i == 0)
+            scopePath.startNewSubPath(pixelCoordX, pixelCoordY);
+        else
+            scopePath.lineTo(pixelCoordX, pixelCoordY);
+    }
+
+    g.setColour(Colour(BORDER_COLOR_HEX));
+    g.strokePath(scopePath, PathStrokeType(2.f));
+}
+
+//================================================================================================
+// SPECTRUM
+
+void AnalyzerDisplayComponent::updateSpectrum()
+{
+    // oldest to newest over the last fft window
+    for (int i = 0; i < ANALYZER_FFT_SIZE; ++i)
+    {
+        fftData[(size_t) i] = getHistorySample(ANALYZER_FFT_SIZE - 1 - i);
+    }
+    std::fill(fftData.begin() + ANALYZER_FFT_SIZE, fftData.end(), 0.f);
+
+    window.multiplyWithWindowingTable(fftData.data(), ANALYZER_FFT_SIZE);
+    fft.performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+    // a full-scale sine peaks at size / 4 through a hann window; levels fall back slowly
+    const float magnitudeScale = 4.f / (float) ANALYZER_FFT_SIZE;
+    const float decayDecibelsPerFrame = 60.f / (float) ANALYZER_FRAME_RATE_HZ;
+
+    for (size_t bin = 0; bin < spectrumLevels.size(); ++bin)
+    {
+        auto level = juce::Decibels::gainToDecibels(fftData[bin] * magnitudeScale, ANALYZER_MIN_DECIBELS);
+        spectrumLevels[bin] = juce::jmax(level, spectrumLevels[bin] - decayDecibelsPerFrame);
+    }
+}
+
+// log frequency axis from 20 Hz to nyquist, level axis from -96 dB to 0 dB
+void AnalyzerDisplayComponent::paintSpectrum(juce::Graphics &g, juce::Rectangle<float> area)
+{
+    using namespace juce;
+
+    const auto sampleRate = (float) audioProcessor.getSampleRate();
+    if (sampleRate <= 0.f)
+        return;
+
+    const float nyquist = sampleRate / 2.f;
+    const int numXPixels = (int) area.getWidth();
+    const int lastBin = (int) spectrumLevels.size() - 1;
+
+    Path spectrumPath;
+    spectrumPath.preallocateSpace(3 * (numXPixels + 3));
+    spectrumPath.startNewSubPath(area.getX(), area.getBottom());
+
+    for (int x = 0; x <= numXPixels; ++x)
+    {
+        auto frequency = ANALYZER_MIN_FREQUENCY * std::pow(nyquist / ANALYZER_MIN_FREQUENCY, (float) x / (float) numXPixels);
+        auto bin = jlimit(0, lastBin, roundToInt(frequency / sampleRate * (float) ANALYZER_FFT_SIZE));
+        auto level = spectrumLevels[(size_t) bin];
+        auto pixelCoordY = jmap(level, ANALYZER_MIN_DECIBELS, 0.f, area.getBottom(), area.getY());
+        spectrumPath.lineTo(area.getX() + (float) x, pixelCoordY);
+    }
+
+    spectrumPath.lineTo(area.getRight(), area.getBottom());
+    spectrumPath.closeSubPath();
+
+    g.setColour(Colour(SCREEN_SHADOW_COLOR_HEX));
+    g.fillPath(spectrumPath);
+    g.setColour(Colour(BORDER_COLOR_HEX));
+    g.strokePath(spectrumPath, PathStrokeType(1.5f));
+}
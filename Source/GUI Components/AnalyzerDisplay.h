@@ -0,0 +1,60 @@
+#ifndef ANALYZER_DISPLAY_H
+#define ANALYZER_DISPLAY_H
+
+#include <JuceHeader.h>
+#include "../PluginProcessor.h"
+
+#define ANALYZER_FFT_ORDER 11
+#define ANALYZER_FFT_SIZE (1 << ANALYZER_FFT_ORDER)
+#define ANALYZER_HISTORY_SIZE (2 * ANALYZER_FFT_SIZE)
+#define ANALYZER_FRAME_RATE_HZ 30
+
+//================================================================================================
+// triggered oscilloscope and spectrum of the processor output, fed from the audio
+// thread through a wait-free fifo and analysed on the message thread
+
+struct AnalyzerDisplayComponent :
+    juce::Component,
+    juce::Timer
+{
+public:
+
+    // CONSTRUCTORS / DESTRUCTORS
+    AnalyzerDisplayComponent(WavetableSynthAudioProcessor&);
+    ~AnalyzerDisplayComponent();
+
+    // COMPONENT OVERRIDES
+    void paint(juce::Graphics& g) override;
+    void visibilityChanged() override;
+
+    // TIMER CAPS THE ANALYSIS RATE
+    void timerCallback() override;
+
+private:
+
+    // REFERENCE TO AUDIO PROCESSOR
+    WavetableSynthAudioProcessor& audioProcessor;
+
+    // SAMPLE HISTORY
+    std::vector<float> incomingSamples;
+    std::vector<float> history;
+    int historyWritePosition{ 0 };
+    bool pullSamples();
+    float getHistorySample(int samplesAgo) const;
+
+    // OSCILLOSCOPE
+    std::vector<float> scopeSamples;
+    int findTriggerSamplesAgo(int windowSize) const;
+    void updateScope();
+    void paintScope(juce::Graphics &g, juce::Rectangle<float> area);
+
+    // SPECTRUM
+    juce::dsp::FFT fft{ ANALYZER_FFT_ORDER };
+    juce::dsp::WindowingFunction<float> window{ ANALYZER_FFT_SIZE, juce::dsp::WindowingFunction<float>::hann };
+    std::vector<float> fftData;
+    std::vector<float> spectrumLevels;
+    void updateSpectrum();
+    void paintSpectrum(juce::Graphics &g, juce::Rectangle<float> area);
+};
+
+#endif // ANALYZER_DISPLAY_H
@@ -122,7 +122,7 @@ DetuneAndWarpControlBar::DetuneAndWarpControlBar() :
 	detuneVoiceSlider.setTextBoxStyle(juce::Slider::TextEntryBoxPosition::NoTextBox, false, 0, 0);
 	detuneVoiceSlider.setVelocityBasedMode(true);
 	detuneVoiceSlider.setVelocityModeParameters(0.25, 1, 0.1, true);
-	detuneVoiceSlider.setRange(1, 16, 1);
+	detuneVoiceSlider.setRange(1, MAX_DETUNE_VOICES, 1);
 	detuneVoiceSlider.setSliderStyle(juce::Slider::SliderStyle::LinearVertical);
 	detuneVoiceSlider.setLookAndFeel(&detuneVoiceSliderLNF);
 	addAndMakeVisible(detuneVoiceSlider);
@@ -2,6 +2,7 @@
 #define DETUNE_AND_WARP_CONTROLS_H
 
 #include <JuceHeader.h>
+#include "../Synthesizer/Oscillator.h"
 
 enum WarpModes {
     Sync = 0,
@@ -0,0 +1,77 @@
+#include "FilmstripCache.h"
+
+//================================================================================================
+// CONSTRUCTORS / DESTRUCTORS
+
+FilmstripCache::FilmstripCache()
+{
+}
+
+FilmstripCache::~FilmstripCache()
+{
+}
+
+//================================================================================================
+// FRAME LOOKUP
+
+int FilmstripCache::getFrameIndex(float position, int numFrames)
+{
+    return juce::jlimit(0, numFrames - 1, juce::roundToInt(position * (float) (numFrames - 1)));
+}
+
+float FilmstripCache::getFramePosition(int frameIndex, int numFrames)
+{
+    return numFrames > 1 ? (float) frameIndex / (float) (numFrames - 1) : 0.f;
+}
+
+void FilmstripCache::drawFrame(juce::Graphics &g, const juce::Image &filmstrip, juce::Rectangle<int> frameBounds, int numFrames, float position)
+{
+    if (filmstrip.isNull() || numFrames <= 0)
+        return;
+
+    const int frameHeightPixels = filmstrip.getHeight() / numFrames;
+    const int frameIndex = getFrameIndex(position, numFrames);
+
+    g.drawImage(filmstrip,
+        frameBounds.getX(), frameBounds.getY(), frameBounds.getWidth(), frameBounds.getHeight(),
+        0, frameIndex * frameHeightPixels, filmstrip.getWidth(), frameHeightPixels);
+}
+
+//================================================================================================
+// RENDERING
+
+FilmstripCache::Filmstrip FilmstripCache::createFilmstrip(juce::Rectangle<int> frameBounds, float scaleFactor, int numFrames)
+{
+    Filmstrip filmstrip;
+    filmstrip.scaleFactor = scaleFactor;
+    filmstrip.numFrames = numFrames;
+    filmstrip.frameWidthPixels = juce::jmax(1, juce::roundToInt((float) frameBounds.getWidth() * scaleFactor));
+    filmstrip.frameHeightPixels = juce::jmax(1, juce::roundToInt((float) frameBounds.getHeight() * scaleFactor));
+    filmstrip.image = juce::Image(juce::Image::ARGB, filmstrip.frameWidthPixels, filmstrip.frameHeightPixels * numFrames, true);
+    return filmstrip;
+}
+
+// clip to the frame's slot and map the control's coordinates onto it
+void FilmstripCache::prepareFrameContext(juce::Graphics &g, const Filmstrip &filmstrip, juce::Rectangle<int> frameBounds, int frameIndex)
+{
+    const int frameTop = frameIndex * filmstrip.frameHeightPixels;
+    g.reduceClipRegion(0, frameTop, filmstrip.frameWidthPixels, filmstrip.frameHeightPixels);
+
+    g.addTransform(juce::AffineTransform::translation((float) -frameBounds.getX(), (float) -frameBounds.getY())
+        .scaled((float) filmstrip.frameWidthPixels / (float) frameBounds.getWidth(),
+                (float) filmstrip.frameHeightPixels / (float) frameBounds.getHeight())
+        .translated(0.f, (float) frameTop));
+}
+
+//================================================================================================
+// KEY
+
+bool FilmstripCache::FilmstripKey::operator<(const FilmstripKey &other) const
+{
+    if (style != other.style)
+        return style < other.style;
+
+    const auto lhs = std::make_tuple(frameBounds.getX(), frameBounds.getY(), frameBounds.getWidth(), frameBounds.getHeight());
+    const auto rhs = std::make_tuple(other.frameBounds.getX(), other.frameBounds.getY(), other.frameBounds.getWidth(), other.frameBounds.getHeight());
+    return lhs < rhs;
+}
@@ -0,0 +1,79 @@
+#ifndef FILMSTRIP_CACHE_H
+#define FILMSTRIP_CACHE_H
+
+#include <JuceHeader.h>
+
+//================================================================================================
+// pre-rendered positions of a control style, stacked vertically in one image at the
+// physical pixel scale they are painted at; shared by every editor in the process
+// through juce::SharedResourcePointer and only touched on the message thread
+
+class FilmstripCache
+{
+public:
+
+    // CONSTRUCTORS / DESTRUCTORS
+    FilmstripCache();
+    ~FilmstripCache();
+
+    // returns the filmstrip for a style drawn into frameBounds, rendering it on first use or
+    // whenever the scale factor has changed; renderFrame(g, position) draws the control at a
+    // normalised position in the same coordinates it would use when painting directly
+    template <typename FrameRenderer>
+    const juce::Image &getFilmstrip(const juce::String &style, juce::Rectangle<int> frameBounds,
+                                    float scaleFactor, int numFrames, FrameRenderer &&renderFrame)
+    {
+        auto &filmstrip = filmstrips[{ style, frameBounds }];
+
+        if (frameBounds.isEmpty() || numFrames <= 0)
+            return filmstrip.image;
+
+        if (filmstrip.image.isNull() || filmstrip.scaleFactor != scaleFactor || filmstrip.numFrames != numFrames)
+        {
+            filmstrip = createFilmstrip(frameBounds, scaleFactor, numFrames);
+
+            for (int frameIndex = 0; frameIndex < numFrames; ++frameIndex)
+            {
+                juce::Graphics g(filmstrip.image);
+                prepareFrameContext(g, filmstrip, frameBounds, frameIndex);
+                renderFrame(g, getFramePosition(frameIndex, numFrames));
+            }
+        }
+
+        return filmstrip.image;
+    }
+
+    // blits the frame nearest to position into frameBounds
+    static void drawFrame(juce::Graphics &g, const juce::Image &filmstrip, juce::Rectangle<int> frameBounds, int numFrames, float position);
+
+    static int getFrameIndex(float position, int numFrames);
+    static float getFramePosition(int frameIndex, int numFrames);
+
+private:
+
+    struct FilmstripKey
+    {
+        juce::String style;
+        juce::Rectangle<int> frameBounds;
+
+        bool operator<(const FilmstripKey &other) const;
+    };
+
+    struct Filmstrip
+    {
+        juce::Image image;
+        float scaleFactor{ 1.f };
+        int numFrames{ 0 };
+        int frameWidthPixels{ 0 };
+        int frameHeightPixels{ 0 };
+    };
+
+    std::map<FilmstripKey, Filmstrip> filmstrips;
+
+    static Filmstrip createFilmstrip(juce::Rectangle<int> frameBounds, float scaleFactor, int numFrames);
+    static void prepareFrameContext(juce::Graphics &g, const Filmstrip &filmstrip, juce::Rectangle<int> frameBounds, int frameIndex);
+
+    JUCE_DECLARE_NON_COPYABLE(FilmstripCache)
+};
+
+#endif // FILMSTRIP_CACHE_H
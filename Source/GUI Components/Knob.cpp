@@ -20,53 +20,74 @@ void KnobLookAndFeel::drawRotarySlider(
 ) {
     using namespace juce;
 
-    if (auto *knob = dynamic_cast<Knob *>(&slider)) {
+    // painting is a blit from the shared filmstrip, rendered once per size and scale
+    if (dynamic_cast<Knob *>(&slider) != nullptr) {
 
-        auto bounds = Rectangle<float>(float(x), float(y), float(width), float(height));
-        auto knobBounds = bounds.removeFromTop(bounds.getWidth());
-        knobBounds.removeFromTop(width * 0.04f);
-        knobBounds.removeFromBottom(width * 0.04f);
-        knobBounds.removeFromLeft(width * 0.04f);
-        knobBounds.removeFromRight(width * 0.04f);
+        auto frameBounds = Rectangle<int>(x, y, width, height);
+        auto scaleFactor = g.getInternalContext().getPhysicalPixelScaleFactor();
 
-        //---------------------------------------------------------------------
-        // DRAW KNOB BODY
+        auto &filmstrip = filmstripCache->getFilmstrip("KNOB", frameBounds, scaleFactor, KNOB_FILMSTRIP_FRAMES,
+            [&](Graphics &frameGraphics, float framePosition) {
+                drawKnobFrame(frameGraphics, x, y, width, height, framePosition, rotaryStartAngle, rotaryEndAngle);
+            });
 
-        // draw knob background
-        g.setColour(Colour(KnobColors::fillColor));
-        g.fillEllipse(knobBounds);
+        FilmstripCache::drawFrame(g, filmstrip, frameBounds, KNOB_FILMSTRIP_FRAMES, sliderPosProportional);
+    }
+}
 
-        // draw knob border
-        g.setColour(Colour(KnobColors::borderColor));
-        g.drawEllipse(knobBounds, 5.f);
+void KnobLookAndFeel::drawKnobFrame(
+    juce::Graphics &g,
+    int x, int y, int width, int height,
+    float sliderPosProportional,
+    float rotaryStartAngle,
+    float rotaryEndAngle
+) {
+    using namespace juce;
 
-        //---------------------------------------------------------------------
-        // DRAW KNOB THUMB
+    auto bounds = Rectangle<float>(float(x), float(y), float(width), float(height));
+    auto knobBounds = bounds.removeFromTop(bounds.getWidth());
+    knobBounds.removeFromTop(width * 0.04f);
+    knobBounds.removeFromBottom(width * 0.04f);
+    knobBounds.removeFromLeft(width * 0.04f);
+    knobBounds.removeFromRight(width * 0.04f);
 
-        // parameters to mess with
-        const float thumbWidthProportionalToDiameter = 0.1f;
-        const float thumbLengthProportionalToRadius = 0.66f;
+    //---------------------------------------------------------------------
+    // DRAW KNOB BODY
+
+    // draw knob background
+    g.setColour(Colour(KnobColors::fillColor));
+    g.fillEllipse(knobBounds);
 
-        const auto knobCenter = knobBounds.getCentre();
-        const auto knobDiameter = knobBounds.getWidth();
-        const auto knobRadius = knobDiameter / 2;
+    // draw knob border
+    g.setColour(Colour(KnobColors::borderColor));
+    g.drawEllipse(knobBounds, 5.f);
 
-        const auto thumbWidth = knobDiameter * thumbWidthProportionalToDiameter;
-        const auto thumbX = knobCenter.getX() - (thumbWidth / 2);
-        const auto thumbY = knobRadius * thumbLengthProportionalToRadius;
-        const auto thumbHeight = knobBounds.getY() - thumbY;
+    //---------------------------------------------------------------------
+    // DRAW KNOB THUMB
 
-        // create path according to knob position and dimensions
-        Path thumbPath;
-        thumbPath.addRoundedRectangle(thumbX, thumbY, thumbWidth, thumbHeight, 2.5f);
+    // parameters to mess with
+    const float thumbWidthProportionalToDiameter = 0.1f;
+    const float thumbLengthProportionalToRadius = 0.66f;
 
-        auto sliderAngRad = jmap(sliderPosProportional, 0.f, 1.f, rotaryStartAngle, rotaryEndAngle);
-        thumbPath.applyTransform(AffineTransform().rotated(sliderAngRad, knobCenter.getX(), knobCenter.getY()));
+    const auto knobCenter = knobBounds.getCentre();
+    const auto knobDiameter = knobBounds.getWidth();
+    const auto knobRadius = knobDiameter / 2;
 
-        // draw thumb as rounded rectangle
-        g.setColour(Colour(KnobColors::borderColor));
-        g.fillPath(thumbPath);
-    }
+    const auto thumbWidth = knobDiameter * thumbWidthProportionalToDiameter;
+    const auto thumbX = knobCenter.getX() - (thumbWidth / 2);
+    const auto thumbY = knobRadius * thumbLengthProportionalToRadius;
+    const auto thumbHeight = knobBounds.getY() - thumbY;
+
+    // create path according to knob position and dimensions
+    Path thumbPath;
+    thumbPath.addRoundedRectangle(thumbX, thumbY, thumbWidth, thumbHeight, 2.5f);
+
+    auto sliderAngRad = jmap(sliderPosProportional, 0.f, 1.f, rotaryStartAngle, rotaryEndAngle);
+    thumbPath.applyTransform(AffineTransform().rotated(sliderAngRad, knobCenter.getX(), knobCenter.getY()));
+
+    // draw thumb as rounded rectangle
+    g.setColour(Colour(KnobColors::borderColor));
+    g.fillPath(thumbPath);
 }
 
  
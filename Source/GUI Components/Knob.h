@@ -2,6 +2,9 @@
 #define KNOB_H
 
 #include <JuceHeader.h>
+#include "FilmstripCache.h"
+
+#define KNOB_FILMSTRIP_FRAMES 128
 
 //====================================================================
 // KNOB LOOK AND FEEL
@@ -14,6 +17,15 @@ struct KnobLookAndFeel : juce::LookAndFeel_V4
         float rotaryStartAngle,
         float rotaryEndAngle,
         juce::Slider&) override;
+
+private:
+    juce::SharedResourcePointer<FilmstripCache> filmstripCache;
+
+    void drawKnobFrame(juce::Graphics&,
+        int x, int y, int width, int height,
+        float sliderPosProportional,
+        float rotaryStartAngle,
+        float rotaryEndAngle);
 };
 
 //====================================================================
@@ -0,0 +1,151 @@
+#include "PerformanceHud.h"
+
+//================================================================================================
+// CONSTRUCTORS / DESTRUCTORS
+
+PerformanceHudComponent::PerformanceHudComponent(WavetableSynthAudioProcessor &p) :
+    audioProcessor(p)
+{
+    setInterceptsMouseClicks(false, false);
+}
+
+PerformanceHudComponent::~PerformanceHudComponent()
+{
+    audioProcessor.getProfiler().setEnabled(false);
+}
+
+//================================================================================================
+// COMPONENT OVERRIDES
+
+void PerformanceHudComponent::paint(juce::Graphics &g)
+{
+    using namespace juce;
+
+    //------------------------------------------------------------------------
+    // PAINT BACKGROUND
+
+    g.setColour(Colour(SCREEN_MAIN_COLOR_HEX).withAlpha(0.92f));
+    g.fillRect(getLocalBounds());
+
+    auto border = getLocalBounds().toFloat();
+    g.setColour(Colour(BORDER_COLOR_HEX));
+    g.drawRect(border, 5.f);
+
+    //------------------------------------------------------------------------
+    // PAINT TOTALS
+
+    juce::FontOptions fontOptions;
+    juce::Font hudFont(fontOptions);
+    hudFont.setBold(true);
+    hudFont.setHeight(14);
+    hudFont.setTypefaceName(hudFont.getDefaultMonospacedFontName());
+    g.setFont(hudFont);
+
+    const int lineHeight = 18;
+    auto area = getLocalBounds().reduced(12);
+
+    auto drawLine = [&](const String &text) {
+        g.drawText(text, area.removeFromTop(lineHeight), Justification::centredLeft, false);
+    };
+
+    if (summary.numBlocks == 0)
+    {
+        drawLine("WAITING FOR AUDIO");
+        return;
+    }
+
+    drawLine("DSP LOAD   " + String(summary.dspLoad * 100.0, 1) + " %");
+    drawLine("AVG BLOCK  " + String(summary.averageBlockSeconds * 1000.0, 3) + " ms");
+    drawLine("PEAK BLOCK " + String(summary.peakBlockSeconds * 1000.0, 3) + " ms");
+    drawLine("VOICES     " + String(summary.numActiveVoices) + " x " + String(summary.numUnisonLanes));
+    area.removeFromTop(lineHeight / 2);
+
+    //------------------------------------------------------------------------
+    // PAINT STAGE SHARES
+
+    for (int stage = 0; stage < (int) ProfileStage::NumStages; ++stage)
+    {
+        auto row = area.removeFromTop(lineHeight);
+        auto share = summary.stageShares[stage];
+
+        g.setColour(Colour(BORDER_COLOR_HEX));
+        g.drawText(BlockProfiler::getStageName((ProfileStage) stage), row.removeFromLeft(70), Justification::centredLeft, false);
+        g.drawText(String(share * 100.0, 1) + "%", row.removeFromRight(50), Justification::centredRight, false);
+
+        auto bar = row.reduced(4, 4).toFloat();
+        g.setColour(Colour(SCREEN_SHADOW_COLOR_HEX));
+        g.fillRect(bar);
+        g.setColour(Colour(CONTROL_SURFACE_COLOR_HEX));
+        g.fillRect(bar.withWidth(bar.getWidth() * (float) jlimit(0.0, 1.0, share)));
+    }
+}
+
+// timings are only collected while the overlay is on screen
+void PerformanceHudComponent::visibilityChanged()
+{
+    audioProcessor.getProfiler().setEnabled(isVisible());
+
+    if (isVisible())
+    {
+        summary = Summary();
+        startTimerHz(PERFORMANCE_HUD_REFRESH_RATE_HZ);
+    }
+    else
+    {
+        stopTimer();
+    }
+}
+
+//================================================================================================
+// TIMER SUMMARISES THE BLOCKS SINCE THE LAST REFRESH
+
+void PerformanceHudComponent::timerCallback()
+{
+    if (summariseProfiles())
+        repaint();
+}
+
+// returns false if no blocks were processed since the last refresh
+bool PerformanceHudComponent::summariseProfiles()
+{
+    auto &profiler = audioProcessor.getProfiler();
+
+    double totalBlockSeconds = 0.0;
+    double totalDurationSeconds = 0.0;
+    double peakBlockSeconds = 0.0;
+    double totalStageSeconds[(int) ProfileStage::NumStages]{};
+    int numBlocks = 0;
+
+    int numPulled;
+    while ((numPulled = profiler.popProfiles(pulledProfiles, PERFORMANCE_HUD_MAX_PROFILES_PER_PULL)) > 0)
+    {
+        for (int i = 0; i < numPulled; ++i)
+        {
+            const auto &profile = pulledProfiles[i];
+
+            totalBlockSeconds += profile.blockSeconds;
+            totalDurationSeconds += profile.blockDurationSeconds;
+            peakBlockSeconds = juce::jmax(peakBlockSeconds, profile.blockSeconds);
+
+            for (int stage = 0; stage < (int) ProfileStage::NumStages; ++stage)
+                totalStageSeconds[stage] += profile.stageSeconds[stage];
+        }
+
+        summary.numActiveVoices = pulledProfiles[numPulled - 1].numActiveVoices;
+        summary.numUnisonLanes = pulledProfiles[numPulled - 1].numUnisonLanes;
+        numBlocks += numPulled;
+    }
+
+    if (numBlocks == 0)
+        return false;
+
+    summary.numBlocks = numBlocks;
+    summary.dspLoad = totalDurationSeconds > 0.0 ? totalBlockSeconds / totalDurationSeconds : 0.0;
+    summary.averageBlockSeconds = totalBlockSeconds / numBlocks;
+    summary.peakBlockSeconds = peakBlockSeconds;
+
+    for (int stage = 0; stage < (int) ProfileStage::NumStages; ++stage)
+        summary.stageShares[stage] = totalBlockSeconds > 0.0 ? totalStageSeconds[stage] / totalBlockSeconds : 0.0;
+
+    return true;
+}
@@ -0,0 +1,52 @@
+#ifndef PERFORMANCE_HUD_H
+#define PERFORMANCE_HUD_H
+
+#include <JuceHeader.h>
+#include "../PluginProcessor.h"
+
+#define PERFORMANCE_HUD_REFRESH_RATE_HZ 4
+#define PERFORMANCE_HUD_MAX_PROFILES_PER_PULL 64
+
+//================================================================================================
+// overlay showing where processBlock spends its time; the processor only measures
+// while the overlay is visible
+
+struct PerformanceHudComponent :
+    juce::Component,
+    juce::Timer
+{
+public:
+
+    // CONSTRUCTORS / DESTRUCTORS
+    PerformanceHudComponent(WavetableSynthAudioProcessor&);
+    ~PerformanceHudComponent();
+
+    // COMPONENT OVERRIDES
+    void paint(juce::Graphics& g) override;
+    void visibilityChanged() override;
+
+    // TIMER SUMMARISES THE BLOCKS SINCE THE LAST REFRESH
+    void timerCallback() override;
+
+private:
+
+    // REFERENCE TO AUDIO PROCESSOR
+    WavetableSynthAudioProcessor& audioProcessor;
+
+    // BLOCK SUMMARY
+    struct Summary
+    {
+        int numBlocks{ 0 };
+        double dspLoad{ 0.0 };
+        double averageBlockSeconds{ 0.0 };
+        double peakBlockSeconds{ 0.0 };
+        double stageShares[(int) ProfileStage::NumStages]{};
+        int numActiveVoices{ 0 };
+        int numUnisonLanes{ 0 };
+    } summary;
+
+    BlockProfile pulledProfiles[PERFORMANCE_HUD_MAX_PROFILES_PER_PULL];
+    bool summariseProfiles();
+};
+
+#endif // PERFORMANCE_HUD_H
@@ -8,23 +8,17 @@ WavetableDisplayComponent::WavetableDisplayComponent(WavetableSynthAudioProcesso
 {
     wavetableRef = audioProcessor.synthesizer.getWavetableReadPointer();
     wavetableCurrentFrameIndex = 0;
+    wavetableNumFrames = 0;
 
-    const auto& params = audioProcessor.getParameters();
-    for (auto param : params)
-    {
-        param->addListener(this);
-    }
+    // the curve only changes on frame or table changes, so keep the last
+    // rendered result around for repaints triggered by overlapping components
+    setBufferedToImage(true);
 
     startTimerHz(24);
 }
 
 WavetableDisplayComponent::~WavetableDisplayComponent()
 {
-    const auto& params = audioProcessor.getParameters();
-    for (auto param : params)
-    {
-        param->removeListener(this);
-    }
 }
 
 //================================================================================================
@@ -41,43 +35,87 @@ void WavetableDisplayComponent::paint(juce::Graphics& g)
     //------------------------------------------------------------------------
     // PAINT WAVETABLE WAVE
     
-    Path wavetableCurve = createPathFromWavetable();
+    updatePaths();
+
+    if (showsFrameStack())
+    {
+        paintFrameStack(g);
+    }
+    else
+    {
+        paintSingleFrame(g);
+    }
+
+    //------------------------------------------------------------------------
+    // PAINT BORDER
+
+    auto border = getLocalBounds().toFloat();
+    g.setColour(Colour(BORDER_COLOR_HEX));
+    g.drawRect(border, 5.f);
+}
+
+void WavetableDisplayComponent::paintSingleFrame(juce::Graphics &g)
+{
+    using namespace juce;
     
     // draw shadow
     g.setColour(Colour(SCREEN_SHADOW_COLOR_HEX));
-    g.fillPath(wavetableCurve);
+    g.fillPath(cachedWavetableCurve);
 
     // draw 0 line
-    Path lineLevel = createLineLevelPath();
     g.setColour(Colour(0xFF97C6AE));
-    g.strokePath(lineLevel, PathStrokeType(1.5f));
+    g.strokePath(cachedLineLevel, PathStrokeType(1.5f));
     
     // draw line
     g.setColour(Colour(BORDER_COLOR_HEX));
-    g.strokePath(wavetableCurve, PathStrokeType(3.f));
+    g.strokePath(cachedWavetableCurve, PathStrokeType(3.f));
+}
 
-    //------------------------------------------------------------------------
-    // PAINT BORDER
+// composite the background-rendered stack with the current frame highlighted on top
+void WavetableDisplayComponent::paintFrameStack(juce::Graphics &g)
+{
+    using namespace juce;
+
+    auto stackImage = stackRenderer.getImage();
+    if (stackImage.isValid())
+    {
+        g.drawImage(stackImage, getLocalBounds().toFloat());
+    }
+    stackFramesShown = stackRenderer.getNumFramesRendered();
+
+    g.setColour(Colour(SCREEN_SHADOW_COLOR_HEX));
+    g.fillPath(cachedWavetableCurve);
 
-    auto border = getLocalBounds().toFloat();
     g.setColour(Colour(BORDER_COLOR_HEX));
-    g.drawRect(border, 5.f);
+    g.strokePath(cachedWavetableCurve, PathStrokeType(2.f));
 }
 
 void WavetableDisplayComponent::resized()
 {
-   
+    pathsNeedUpdate = true;
+    requestStackRender();
 }
 
 //================================================================================================
-// WAVETABLE UPDATE SIGNAL
+// FRAME STACK
+
+bool WavetableDisplayComponent::showsFrameStack() const
+{
+    return wavetableRef != nullptr && wavetableRef->getNumChannels() > 1;
+}
 
-void WavetableDisplayComponent::parameterValueChanged(int parameterIndex, float newValue)
+void WavetableDisplayComponent::requestStackRender()
 {
-    juce::ignoreUnused(parameterIndex, newValue);
-    wavetableChanged.set(true);
+    if (!showsFrameStack())
+        return;
+
+    stackScaleFactor = juce::Component::getApproximateScaleFactorForComponent(this);
+    stackRenderer.requestRender(wavetableRef, getLocalBounds(), stackScaleFactor);
 }
 
+//================================================================================================
+// WAVETABLE UPDATE SIGNAL
+
 void WavetableDisplayComponent::updateWavetable()
 {   
     int resolution = 512;
@@ -86,23 +124,31 @@ void WavetableDisplayComponent::updateWavetable()
 }
 
 //================================================================================================
-// TIMER SETS REFRESH RATE
+// TIMER POLLS RENDER STATE
 
+// the displayed frame comes from the audio thread's published snapshot, so no
+// parameter listeners are needed; repaint only when the frame or table changed
 void WavetableDisplayComponent::timerCallback()
 {    
-    if (wavetableChanged.compareAndSetBool(false, true))
+    const auto &renderState = audioProcessor.getRenderState();
+    const int lastFrameIndex = juce::jmax(0, renderState.numWavetableFrames - 1);
+    const int newFrameIndex = juce::jlimit(0, lastFrameIndex, renderState.wavetableFrameIndex);
+
+    if (newFrameIndex != wavetableCurrentFrameIndex || renderState.numWavetableFrames != wavetableNumFrames)
     {
-        wavetableCurrentFrameIndex = (int) audioProcessor.valueTree.getRawParameterValue("OSC_WAVETABLE_CURRENT_FRAME")->load();
-        if (wavetableCurrentFrameIndex < 0) {
-            wavetableCurrentFrameIndex = 0;
-        }
-        else if (wavetableCurrentFrameIndex > audioProcessor.synthesizer.getNumWavetableFrames() - 1)
-        {
-            wavetableCurrentFrameIndex = audioProcessor.synthesizer.getNumWavetableFrames() - 1;
-        }
+        wavetableCurrentFrameIndex = newFrameIndex;
+        wavetableNumFrames = renderState.numWavetableFrames;
+        pathsNeedUpdate = true;
     }
     
-    repaint();
+    // re-render the stack when the editor moves to a display with a different scale
+    if (showsFrameStack() && juce::Component::getApproximateScaleFactorForComponent(this) != stackScaleFactor)
+    {
+        requestStackRender();
+    }
+
+    if (pathsNeedUpdate || stackRenderer.getNumFramesRendered() != stackFramesShown)
+        repaint();
 }
 
 
@@ -152,29 +198,36 @@ float WavetableDisplayComponent::getLinearlyInterpolatedWavetableSample(float ph
     int sampleIndex = static_cast<int>(scaledPhase);
     float sampleOffset = scaledPhase - static_cast<float>(sampleIndex);
 
-    // select the samples around sampleIndex
     auto samples = wavetableRef->getReadPointer(wavetableCurrentFrameIndex);
-    float val1 = samples[sampleIndex % wavetableSize];
-    float val2 = samples[(sampleIndex + 1) % wavetableSize];
-
-    // perform linear interpolation
-    float result = val1 + sampleOffset * (val2 - val1);
+    float result = interpolateLinear(samples, wavetableSize, sampleIndex, sampleOffset);
 
     return result;
 }
 
-juce::Path WavetableDisplayComponent::createPathFromWavetable()
+void WavetableDisplayComponent::updatePaths()
 {
-    //------------------------------------------------------------------------
-    // COPY AUDIO BUFFER
+    if (!pathsNeedUpdate)
+        return;
 
-    std::vector<float> mags;
-    mags.reserve(wavetableRef->getNumSamples());
-    for (int i = 0; i < wavetableRef->getNumSamples(); i++)
+    if (showsFrameStack())
     {
-        mags.push_back((float) wavetableRef->getSample(0, i));
+        // the highlighted frame sits at its own depth in the stack
+        auto stackArea = getLocalBounds().toFloat().reduced(8.f);
+        auto numFrames = wavetableRef->getNumChannels();
+        auto frameBounds = WavetableStackRenderer::getFrameBounds(stackArea, wavetableCurrentFrameIndex, numFrames);
+        cachedWavetableCurve = WavetableStackRenderer::createFramePath(*wavetableRef, wavetableCurrentFrameIndex, frameBounds, juce::roundToInt(frameBounds.getWidth()));
     }
+    else
+    {
+        cachedWavetableCurve = createPathFromWavetable();
+    }
+
+    cachedLineLevel = createLineLevelPath();
+    pathsNeedUpdate = false;
+}
 
+juce::Path WavetableDisplayComponent::createPathFromWavetable()
+{
     //------------------------------------------------------------------------
     // INITIALIZE CALCULATION VALUES
 
@@ -197,6 +250,7 @@ juce::Path WavetableDisplayComponent::createPathFromWavetable()
     // CALCULATE WAVETABLE PATH
 
     juce::Path wavetableCurve;
+    wavetableCurve.preallocateSpace(3 * ((int) numXPixels + 2));
     wavetableCurve.startNewSubPath(baseXPixel, baseYPixel);
 
     for (int x = 0; x < numXPixels; ++x)
@@ -3,10 +3,10 @@
 
 #include <JuceHeader.h>
 #include "../PluginProcessor.h"
+#include "WavetableStackRenderer.h"
 
 struct WavetableDisplayComponent : 
     juce::Component,
-    juce::AudioProcessorParameter::Listener,
     juce::Timer
 {
 public:
@@ -19,13 +19,9 @@ public:
     void paint(juce::Graphics& g) override;
     void resized() override;
 
-    // TIMER SETS REFRESH RATE
+    // TIMER POLLS RENDER STATE
     void timerCallback() override;
 
-    // WAVETABLE UPDATE SIGNAL
-    void parameterValueChanged(int parameterIndex, float newValue) override;
-    void parameterGestureChanged(int parameterIndex, bool gestureIsStarting) override { juce::ignoreUnused(parameterIndex, gestureIsStarting); }
-
 private:
     
     // REFERENCE TO AUDIO PROCESSOR
@@ -33,14 +29,29 @@ private:
 
     const Wavetable *wavetableRef;
     int wavetableCurrentFrameIndex;
+    int wavetableNumFrames;
 
     // WAVETABLE
     juce::AudioBuffer<float> wavetable;
-    juce::Atomic<bool> wavetableChanged{ false };
     void updateWavetable();
     float getHermiteInterpolatedWavetableSample(float phase);
     float getLinearlyInterpolatedWavetableSample(float phase);
 
+    // CACHED PATHS, rebuilt only when the frame, table or bounds change
+    juce::Path cachedWavetableCurve;
+    juce::Path cachedLineLevel;
+    bool pathsNeedUpdate{ true };
+    void updatePaths();
+
+    // FRAME STACK, rendered off the message thread for multi-frame tables
+    WavetableStackRenderer stackRenderer;
+    int stackFramesShown{ 0 };
+    float stackScaleFactor{ 1.f };
+    bool showsFrameStack() const;
+    void requestStackRender();
+    void paintFrameStack(juce::Graphics &g);
+    void paintSingleFrame(juce::Graphics &g);
+
     // PATH PRODUCERS
     juce::Path createPathFromWavetable();
     juce::Path createLineLevelPath();
@@ -7,6 +7,13 @@ enum WavetableSliderColors : uint32_t
     textColor = 0xFF0F1D1F
 };
 
+#define WAVETABLE_SLIDER_TRACK_WIDTH 7
+#define WAVETABLE_SLIDER_THUMB_WIDTH 35
+#define WAVETABLE_SLIDER_THUMB_HEIGHT 14
+
+//====================================================================
+// WT SLIDER LOOK AND FEEL
+
 void WavetableSliderLookAndFeel::drawLinearSlider(
     juce::Graphics &g,
     int x, int y, int width, int height,
@@ -14,10 +21,29 @@ void WavetableSliderLookAndFeel::drawLinearSlider(
     juce::Slider::SliderStyle sliderStyle,
     juce::Slider &slider
 ) {
-   
-    const auto trackWidth = 7;
-    const auto thumbWidth = 35;
-    const auto thumbHeight = 14;
+    // painting is a blit from the shared filmstrip; the frames only cover the thumb's
+    // column, with room above and below for the thumb border at either end of the track
+    auto frameBounds = juce::Rectangle<int>(x, y, width, height)
+        .withSizeKeepingCentre(WAVETABLE_SLIDER_THUMB_WIDTH + 4, height)
+        .expanded(0, 4);
+    auto scaleFactor = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+    auto &filmstrip = filmstripCache->getFilmstrip("WAVETABLE_SLIDER", frameBounds, scaleFactor, WAVETABLE_SLIDER_FILMSTRIP_FRAMES,
+        [&](juce::Graphics &frameGraphics, float framePosition) {
+            drawSliderFrame(frameGraphics, x, y, width, height, framePosition);
+        });
+
+    FilmstripCache::drawFrame(g, filmstrip, frameBounds, WAVETABLE_SLIDER_FILMSTRIP_FRAMES, sliderPos);
+}
+
+void WavetableSliderLookAndFeel::drawSliderFrame(
+    juce::Graphics &g,
+    int x, int y, int width, int height,
+    float sliderPos
+) {
+    const auto trackWidth = WAVETABLE_SLIDER_TRACK_WIDTH;
+    const auto thumbWidth = WAVETABLE_SLIDER_THUMB_WIDTH;
+    const auto thumbHeight = WAVETABLE_SLIDER_THUMB_HEIGHT;
     
     auto bounds = juce::Rectangle<float>(float(x), float(y), float(width), float(height));
 
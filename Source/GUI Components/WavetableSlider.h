@@ -2,6 +2,9 @@
 #define WAVETABLE_SLIDER_H
 
 #include <JuceHeader.h>
+#include "FilmstripCache.h"
+
+#define WAVETABLE_SLIDER_FILMSTRIP_FRAMES 128
 
 //====================================================================
 // WT SLIDER LOOK AND FEEL
@@ -13,6 +16,13 @@ struct WavetableSliderLookAndFeel : juce::LookAndFeel_V4
         float sliderPos, float minSliderPos, float maxSliderPos,
         juce::Slider::SliderStyle, 
         juce::Slider &) override;
+
+private:
+    juce::SharedResourcePointer<FilmstripCache> filmstripCache;
+
+    void drawSliderFrame(juce::Graphics &,
+        int x, int y, int width, int height,
+        float sliderPos);
 };
 
 //====================================================================
@@ -0,0 +1,194 @@
+#include "WavetableStackRenderer.h"
+
+// frames are published in batches so the display fills in progressively
+#define STACK_FRAMES_PER_BATCH 16
+
+//================================================================================================
+// BACKGROUND JOB
+
+class WavetableStackRenderer::StackRenderJob : public juce::ThreadPoolJob
+{
+public:
+
+    StackRenderJob(WavetableStackRenderer &ownerRenderer, int requestGeneration) :
+        juce::ThreadPoolJob("Wavetable Stack Render"),
+        owner(ownerRenderer),
+        generation(requestGeneration)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        owner.renderStack(*this, generation);
+        return jobHasFinished;
+    }
+
+    WavetableStackRenderer &owner;
+
+private:
+    const int generation;
+};
+
+//================================================================================================
+// CONSTRUCTORS / DESTRUCTORS
+
+WavetableStackRenderer::WavetableStackRenderer()
+{
+}
+
+// queued jobs are dropped and a running one is interrupted before the renderer goes away
+WavetableStackRenderer::~WavetableStackRenderer()
+{
+    requestGeneration.fetch_add(1);
+    workerPool->removeBackgroundJobs([this](juce::ThreadPoolJob *job)
+    {
+        auto *stackRenderJob = dynamic_cast<StackRenderJob *>(job);
+        return stackRenderJob != nullptr && &stackRenderJob->owner == this;
+    }, 1000);
+}
+
+//================================================================================================
+// MESSAGE THREAD INTERFACE
+
+// restart rendering for a new table or size; any render in progress is abandoned
+void WavetableStackRenderer::requestRender(const Wavetable *wavetableToRender, juce::Rectangle<int> bounds, float scaleFactor)
+{
+    {
+        const juce::SpinLock::ScopedLockType lock(requestLock);
+        requestedWavetable = wavetableToRender;
+        requestedBounds = bounds;
+        requestedScaleFactor = scaleFactor;
+    }
+
+    numFramesRendered.store(0);
+    const int generation = requestGeneration.fetch_add(1) + 1;
+    workerPool->addBackgroundJob(new StackRenderJob(*this, generation), true);
+}
+
+juce::Image WavetableStackRenderer::getImage() const
+{
+    const juce::SpinLock::ScopedLockType lock(imageLock);
+    return publishedImage;
+}
+
+int WavetableStackRenderer::getNumFramesRendered() const
+{
+    return numFramesRendered.load();
+}
+
+void WavetableStackRenderer::publishImage(const juce::Image &image, int numFrames)
+{
+    {
+        const juce::SpinLock::ScopedLockType lock(imageLock);
+        publishedImage = image;
+    }
+    numFramesRendered.store(numFrames);
+}
+
+//================================================================================================
+// STACK GEOMETRY
+
+// frame 0 sits at the front bottom-left, the last frame at the back top-right
+juce::Rectangle<float> WavetableStackRenderer::getFrameBounds(juce::Rectangle<float> area, int frameIndex, int numFrames)
+{
+    const float depthX = area.getWidth() * 0.25f;
+    const float depthY = area.getHeight() * 0.4f;
+    const float depth = numFrames > 1 ? (float) frameIndex / (float) (numFrames - 1) : 0.f;
+
+    return juce::Rectangle<float>(
+        area.getX() + depth * depthX,
+        area.getY() + (1.f - depth) * depthY,
+        area.getWidth() - depthX,
+        area.getHeight() - depthY
+    );
+}
+
+float WavetableStackRenderer::getFrameSampleValue(const Wavetable &wavetable, int frameIndex, float phase)
+{
+    const int wavetableSize = wavetable.getNumSamples();
+    const float scaledPhase = phase * (float) wavetableSize;
+    const int sampleIndex = (int) scaledPhase;
+    const float sampleOffset = scaledPhase - (float) sampleIndex;
+
+    auto samples = wavetable.getReadPointer(frameIndex);
+    const float val1 = samples[sampleIndex % wavetableSize];
+    const float val2 = samples[(sampleIndex + 1) % wavetableSize];
+
+    return val1 + sampleOffset * (val2 - val1);
+}
+
+// decimate one frame to numColumns points across frameBounds, closed along the zero line
+juce::Path WavetableStackRenderer::createFramePath(const Wavetable &wavetable, int frameIndex, juce::Rectangle<float> frameBounds, int numColumns)
+{
+    const float baseYPixel = frameBounds.getCentreY();
+    const float columnWidth = frameBounds.getWidth() / (float) juce::jmax(1, numColumns);
+
+    juce::Path framePath;
+    framePath.preallocateSpace(3 * (numColumns + 3));
+    framePath.startNewSubPath(frameBounds.getX(), baseYPixel);
+
+    for (int column = 0; column <= numColumns; ++column)
+    {
+        const float phase = (float) column / (float) juce::jmax(1, numColumns);
+        const float value = getFrameSampleValue(wavetable, frameIndex, juce::jmin(phase, 0.9999f)) * 0.6f;
+        const float pixelCoordY = juce::jmap(value, -1.f, 1.f, frameBounds.getBottom(), frameBounds.getY());
+        framePath.lineTo(frameBounds.getX() + column * columnWidth, pixelCoordY);
+    }
+
+    framePath.lineTo(frameBounds.getRight(), baseYPixel);
+    framePath.closeSubPath();
+    return framePath;
+}
+
+//================================================================================================
+// BACKGROUND JOB
+
+// returns false if a newer request arrived before the stack was finished
+bool WavetableStackRenderer::renderStack(juce::ThreadPoolJob &job, int generation)
+{
+    if (requestGeneration.load() != generation)
+        return false;
+
+    const Wavetable *wavetable;
+    juce::Rectangle<int> bounds;
+    float scaleFactor;
+    {
+        const juce::SpinLock::ScopedLockType lock(requestLock);
+        wavetable = requestedWavetable;
+        bounds = requestedBounds;
+        scaleFactor = requestedScaleFactor;
+    }
+
+    if (wavetable == nullptr || bounds.isEmpty() || wavetable->getNumChannels() < 2)
+        return true;
+
+    // render at physical resolution so the image stays sharp on scaled displays
+    const int imageWidth = juce::roundToInt((float) bounds.getWidth() * scaleFactor);
+    const int imageHeight = juce::roundToInt((float) bounds.getHeight() * scaleFactor);
+    juce::Image image(juce::Image::ARGB, imageWidth, imageHeight, true, juce::SoftwareImageType());
+    juce::Graphics g(image);
+
+    const auto area = image.getBounds().toFloat().reduced(8.f * scaleFactor);
+    const int numFrames = wavetable->getNumChannels();
+
+    // back to front, each frame occluding the ones behind it
+    for (int frameIndex = numFrames - 1; frameIndex >= 0; --frameIndex)
+    {
+        if (job.shouldExit() || requestGeneration.load() != generation)
+            return false;
+
+        const auto frameBounds = getFrameBounds(area, frameIndex, numFrames);
+        const auto framePath = createFramePath(*wavetable, frameIndex, frameBounds, juce::roundToInt(frameBounds.getWidth()));
+
+        g.setColour(juce::Colour(SCREEN_MAIN_COLOR_HEX));
+        g.fillPath(framePath);
+        g.setColour(juce::Colour(0xFF97C6AE));
+        g.strokePath(framePath, juce::PathStrokeType(1.f * scaleFactor));
+
+        const int framesDone = numFrames - frameIndex;
+        if (framesDone % STACK_FRAMES_PER_BATCH == 0 || frameIndex == 0)
+            publishImage(image.createCopy(), framesDone);
+    }
+
+    return true;
+}
@@ -0,0 +1,52 @@
+#ifndef WAVETABLE_STACK_RENDERER_H
+#define WAVETABLE_STACK_RENDERER_H
+
+#include <JuceHeader.h>
+#include "../PluginProcessor.h"
+#include "../Utilities/WorkerPool.h"
+
+//================================================================================================
+// renders every frame of a wavetable as a stacked "waterfall" into an image on the shared
+// pool's background thread, publishing partial results so the display can show progress
+
+class WavetableStackRenderer
+{
+public:
+
+    // CONSTRUCTORS / DESTRUCTORS
+    WavetableStackRenderer();
+    ~WavetableStackRenderer();
+
+    // MESSAGE THREAD INTERFACE
+    void requestRender(const Wavetable *wavetableToRender, juce::Rectangle<int> bounds, float scaleFactor);
+    juce::Image getImage() const;
+    int getNumFramesRendered() const;
+
+    // STACK GEOMETRY, shared with the overlay drawn on the message thread
+    static juce::Rectangle<float> getFrameBounds(juce::Rectangle<float> area, int frameIndex, int numFrames);
+    static float getFrameSampleValue(const Wavetable &wavetable, int frameIndex, float phase);
+    static juce::Path createFramePath(const Wavetable &wavetable, int frameIndex, juce::Rectangle<float> frameBounds, int numColumns);
+
+private:
+
+    // BACKGROUND JOB, one per request; a job abandons its render once a newer request exists
+    class StackRenderJob;
+    juce::SharedResourcePointer<WorkerPool> workerPool;
+    bool renderStack(juce::ThreadPoolJob &job, int generation);
+
+    // REQUEST, guarded by requestLock
+    juce::SpinLock requestLock;
+    const Wavetable *requestedWavetable{ nullptr };
+    juce::Rectangle<int> requestedBounds;
+    float requestedScaleFactor{ 1.f };
+    std::atomic<int> requestGeneration{ 0 };
+
+    // RESULT, guarded by imageLock
+    juce::SpinLock imageLock;
+    juce::Image publishedImage;
+    std::atomic<int> numFramesRendered{ 0 };
+
+    void publishImage(const juce::Image &image, int numFrames);
+};
+
+#endif // WAVETABLE_STACK_RENDERER_H
@@ -27,6 +27,8 @@ WavetableSynthAudioProcessorEditor::WavetableSynthAudioProcessorEditor(Wavetable
     coarsePitchTransposeAttachment(audioProcessor.valueTree, "COARSE_TRANSPOSE", transposeBar.coarseSlider),
 
     wavetableDisplay(audioProcessor),
+    analyzerDisplay(audioProcessor),
+    performanceHud(audioProcessor),
 
     // ADSR CONTROLSS
     adsrControls(),
@@ -75,6 +77,12 @@ WavetableSynthAudioProcessorEditor::WavetableSynthAudioProcessorEditor(Wavetable
     addAndMakeVisible(editButton);
 
     viewButton.setButtonText("VIEW");
+    viewButton.onClick = [this] {
+        if (juce::ModifierKeys::getCurrentModifiers().isShiftDown())
+            togglePerformanceHud();
+        else
+            toggleScreenView();
+    };
     addAndMakeVisible(viewButton);
 
     addAndMakeVisible(transposeBar);
@@ -82,10 +90,13 @@ WavetableSynthAudioProcessorEditor::WavetableSynthAudioProcessorEditor(Wavetable
     addAndMakeVisible(detuneVoicesAndWarpModeControls);
 
     addAndMakeVisible(wavetableDisplay);
+    addChildComponent(analyzerDisplay);
     for (auto* knob : getKnobs())
     {
         addAndMakeVisible(knob);
     }
+
+    addChildComponent(performanceHud);
 }
 
 WavetableSynthAudioProcessorEditor::~WavetableSynthAudioProcessorEditor()
@@ -160,6 +171,8 @@ void WavetableSynthAudioProcessorEditor::resized()
     wavetableDisplayArea.removeFromTop(WAVETABLE_DISPLAY_HEIGHT_PIXELS / 4);
     wavetableDisplayArea = wavetableDisplayArea.removeFromTop(WAVETABLE_DISPLAY_HEIGHT_PIXELS);
     wavetableDisplay.setBounds(wavetableDisplayArea);
+    analyzerDisplay.setBounds(wavetableDisplayArea);
+    performanceHud.setBounds(wavetableDisplayArea);
 
     // adsr controls
     auto adsrArea = screenArea;
@@ -234,3 +247,17 @@ std::vector<juce::Component*> WavetableSynthAudioProcessorEditor::getKnobs()
         &oscWavetablePositionKnob
     };
 }
+
+// the VIEW button flips the screen between the wavetable and the output analyzer
+void WavetableSynthAudioProcessorEditor::toggleScreenView()
+{
+    const bool showAnalyzer = !analyzerDisplay.isVisible();
+    analyzerDisplay.setVisible(showAnalyzer);
+    wavetableDisplay.setVisible(!showAnalyzer);
+}
+
+// shift-clicking VIEW shows the processing-time overlay on top of the screen
+void WavetableSynthAudioProcessorEditor::togglePerformanceHud()
+{
+    performanceHud.setVisible(!performanceHud.isVisible());
+}
@@ -12,6 +12,8 @@
 #include "GUI Components/Knob.h"
 #include "GUI Components/WavetableSlider.h"
 #include "GUI Components/WavetableDisplay.h"
+#include "GUI Components/AnalyzerDisplay.h"
+#include "GUI Components/PerformanceHud.h"
 
 enum ColorPalette : uint32_t
 {
@@ -72,6 +74,10 @@ private:
     ControlSurfaceAttachment warpModeAttachment;
 
     struct WavetableDisplayComponent wavetableDisplay;
+    struct AnalyzerDisplayComponent analyzerDisplay;
+    struct PerformanceHudComponent performanceHud;
+    void toggleScreenView();
+    void togglePerformanceHud();
 
     Knob oscVolumeKnob;
     Knob oscPanningKnob;
@@ -9,171 +9,10 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
-void generateSineWavetable(Wavetable& tableToFill, int resolution)
-{
-    tableToFill.setSize(1, resolution);
-    auto* samples = tableToFill.getWritePointer(0);
-
-    auto angleDelta = juce::MathConstants<float>::twoPi / (float)(resolution - 1);
-    auto currentAngle = 0.0;
-
-    for (int i = 0; i < resolution; ++i)
-    {
-        auto sample = std::sin(currentAngle);
-        samples[i] = (float)sample;
-        currentAngle += angleDelta;
-    }
-}
-
-void generateSineFrames(Wavetable &tableToFill, int resolution)
-{
-    tableToFill.setSize(3, resolution);
-
-    auto *samples = tableToFill.getWritePointer(0);
-    auto angleDelta = juce::MathConstants<float>::twoPi / (float)(resolution - 1);
-    auto currentAngle = 0.f;
-
-    for (int i = 0; i < resolution; ++i)
-    {
-        auto sample = std::sin(currentAngle);
-        samples[i] = (float)sample;
-        currentAngle += angleDelta;
-    }
-
-    samples = tableToFill.getWritePointer(1);
-    angleDelta *= 2.f;
-    currentAngle = 0.f;
-
-    for (int i = 0; i < resolution; ++i)
-    {
-        auto sample = std::sin(currentAngle);
-        samples[i] = (float)sample;
-        currentAngle += angleDelta;
-    }
-
-    samples = tableToFill.getWritePointer(2);
-    angleDelta *= 2.f;
-    currentAngle = 0.0;
-
-    for (int i = 0; i < resolution; ++i)
-    {
-        auto sample = std::sin(currentAngle);
-        samples[i] = (float)sample;
-        currentAngle += angleDelta;
-    }
-}
-
-void generateManySineFrames(Wavetable &tableToFill)
-{
-    int numFrames = 255;
-    int numSamples = 1024;
-    
-    tableToFill.setSize(numFrames, numSamples);
-
-    auto angleDelta = juce::MathConstants<float>::twoPi / (float)(numSamples - 1);
-
-    for (int frame = 0; frame < numFrames; frame++)
-    {
-        auto currentAngle = 0.f;
-        auto *samples = tableToFill.getWritePointer(frame);
-        for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
-        {
-            auto sampleValue = std::sin(currentAngle);
-            samples[sampleIndex] = (float) sampleValue;
-            currentAngle += angleDelta;
-        }
-        angleDelta *= 1.005f;
-    }
-}
-
-void generateRandomSineCombinations(Wavetable &tableToFill)
-{
-    int numFrames = 10;
-    int numSamples = 1024;
-
-    tableToFill.setSize(numFrames, numSamples);
-
-    auto angleDelta = juce::MathConstants<float>::twoPi / (float)(numSamples - 1);
-
-    juce::Random rng;
-    for (int frame = 0; frame < numFrames; frame++)
-    {
-        auto currentAngle = 0.f;
-        auto secondAngle = 0.f;
-        auto randomDelta = angleDelta * std::floor(1 + (rng.nextFloat() * 6));
-        //auto randomDelta = angleDelta * rng.nextFloat() * 10;
-        auto *samples = tableToFill.getWritePointer(frame);
-        for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
-        {
-            auto sampleValue = std::sin(currentAngle) * std::cos(secondAngle);
-            samples[sampleIndex] = (float)sampleValue;
-            currentAngle += angleDelta;
-            secondAngle += randomDelta;
-        }
-    }
-}
-
-void generateSquareWavetable(Wavetable& tableToFill, int resolution)
-{
-    tableToFill.setSize(1, resolution);
-    auto* samples = tableToFill.getWritePointer(0);
-
-    for (int i = 0; i < resolution; i++)
-    {
-        samples[i] = (i >= (resolution / 2)) ? -1.f : 1.f;
-    }
-}
-
-void generateSawWavetable(Wavetable& tableToFill, int resolution)
-{
-    tableToFill.setSize(1, resolution);
-    auto* samples = tableToFill.getWritePointer(0);
-
-    for (int i = 0; i < resolution/2; i++)
-    {
-        samples[i] = 0.f + (2.f * (float)i / (float)resolution);
-    }
-    for (int i = resolution / 2; i < resolution; i++)
-    {
-        samples[i] = -2.f + (2.f * (float)i / (float)resolution);
-    }
-}
-
-void generateMultiSineWavetable(Wavetable& tableToFill, int resolution, int coefficientA, int coefficientB)
-{
-    tableToFill.setSize(1, resolution);
-    auto* samples = tableToFill.getWritePointer(0);
-
-    auto angleDelta = juce::MathConstants<float>::twoPi / (float)(resolution - 1);
-    auto currentAngle = 0.0;
-
-    for (int i = 0; i < resolution; ++i)
-    {
-        auto sample = std::sin(currentAngle);
-        samples[i] = (float)sample;
-        currentAngle += angleDelta;
-    }
-
-    for (int i = 0; i < resolution; ++i)
-    {
-        auto sample = std::sin(currentAngle);
-        samples[i] *= (float)sample;
-        currentAngle += coefficientA * angleDelta;
-    }
-
-    for (int i = 0; i < resolution; ++i)
-    {
-        auto sample = std::sin(currentAngle);
-        samples[i] *= (float)sample;
-        currentAngle += coefficientB * angleDelta;
-    }
-}
-
 //==============================================================================
-WavetableSynthAudioProcessor::WavetableSynthAudioProcessor() :
-oversamplingEngine(2, (size_t)std::log(oversampleCoefficient), juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR, true, false)
+WavetableSynthAudioProcessor::WavetableSynthAudioProcessor()
 #ifndef JucePlugin_PreferredChannelConfigurations
-    , AudioProcessor (BusesProperties()
+    : AudioProcessor (BusesProperties()
     #if ! JucePlugin_IsMidiEffect
         #if ! JucePlugin_IsSynth
             .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
@@ -193,10 +32,27 @@ oversamplingEngine(2, (size_t)std::log(oversampleCoefficient), juce::dsp::Oversa
     //generateRandomSineCombinations(wavetable);
     
     synthesizer.setWavetable(wavetable);
+
+    // about 0.7 seconds at 48 kHz, enough to ride out a few slow editor frames
+    analyzerFifo.prepare(1 << 15);
+
+    synthesizer.setProfiler(&profiler);
+    synthesizer.setWorkerPool(&workerPool.get());
+    oversampledRenderer.setProfiler(&profiler);
+
+    // in render-ahead mode the synthesizer is only ever touched from the render thread
+    renderAheadRenderer.onBeforeRender = [this]() { updateSynthesizerParametersFromValueTree(); };
+    renderAheadRenderer.onRendered = [this](const juce::AudioBuffer<float> &buffer) { publishRenderState(buffer); };
+    valueTree.addParameterListener("RENDER_AHEAD_BLOCKS", this);
 }
 
 WavetableSynthAudioProcessor::~WavetableSynthAudioProcessor()
 {
+    valueTree.removeParameterListener("RENDER_AHEAD_BLOCKS", this);
+    cancelPendingUpdate();
+
+    // the render thread publishes into members that are destroyed before it
+    renderAheadRenderer.release();
 }
 
 //==============================================================================
@@ -232,9 +88,12 @@ bool WavetableSynthAudioProcessor::isMidiEffect() const
     #endif
 }
 
+// a released note rings for at most the release time, and the oversampling filters delay it further
 double WavetableSynthAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    const double releaseSeconds = valueTree.getRawParameterValue("ADSR_RELEASE")->load();
+    const double latencySeconds = getSampleRate() > 0.0 ? getLatencySamples() / getSampleRate() : 0.0;
+    return releaseSeconds + latencySeconds;
 }
 
 int WavetableSynthAudioProcessor::getNumPrograms()
@@ -266,16 +125,67 @@ void WavetableSynthAudioProcessor::changeProgramName (int index, const juce::Str
 //==============================================================================
 void WavetableSynthAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-    synthesizer.setSampleRate((float) sampleRate);
+    renderAheadRenderer.release();
+
+    // mono layouts render one channel through every stage. every factor is prepared, so a
+    // profile change or a switch to non-realtime swaps it between blocks without coming back here
+    const int numRenderChannels = getTotalNumOutputChannels() == 1 ? 1 : 2;
+    const auto renderProfile = getActiveRenderProfile();
+    oversampledRenderer.prepare(sampleRate, samplesPerBlock, renderProfile.oversamplingFactor, OVERSAMPLED_RENDER_CHUNK_SIZE, numRenderChannels,
+                                MAX_OVERSAMPLING_FACTOR);
+    applyRenderProfile(synthesizer, renderProfile);
+
+    preparedRenderAheadBlocks = getRenderAheadBlocks();
+    if (preparedRenderAheadBlocks > 0)
+        renderAheadRenderer.prepare(samplesPerBlock, preparedRenderAheadBlocks);
+
+    // stage timings are only meaningful when the synthesizer runs inside the host callback
+    auto *synthesizerProfiler = renderAheadRenderer.isActive() ? nullptr : &profiler;
+    synthesizer.setProfiler(synthesizerProfiler);
+    oversampledRenderer.setProfiler(synthesizerProfiler);
 
-    oversamplingEngine.setUsingIntegerLatency(true);
-    oversamplingEngine.initProcessing(static_cast<size_t>(samplesPerBlock));
+    setLatencySamples((int) oversampledRenderer.getLatencyInSamples() + renderAheadRenderer.getLatencyInSamples());
 
-    setLatencySamples((int) oversamplingEngine.getLatencyInSamples());
+    analyzerScratch.setSize(1, samplesPerBlock, false, true, false);
+    numSilentSamples = 0;
 }
 
 void WavetableSynthAudioProcessor::releaseResources()
 {
+    renderAheadRenderer.release();
+}
+
+// a bounce has no deadline for the headroom to protect, so it always renders inline
+int WavetableSynthAudioProcessor::getRenderAheadBlocks() const
+{
+    if (isNonRealtime())
+        return 0;
+
+    return juce::roundToInt(valueTree.getRawParameterValue("RENDER_AHEAD_BLOCKS")->load());
+}
+
+RenderProfile WavetableSynthAudioProcessor::getActiveRenderProfile()
+{
+    return getRenderProfileFromValueTree(valueTree, isNonRealtime() ? OfflineRenderProfile : RealtimeRenderProfile);
+}
+
+void WavetableSynthAudioProcessor::parameterChanged(const juce::String &parameterID, float newValue)
+{
+    juce::ignoreUnused(parameterID, newValue);
+    triggerAsyncUpdate();
+}
+
+void WavetableSynthAudioProcessor::handleAsyncUpdate()
+{
+    if (getSampleRate() <= 0.0)
+        return;
+
+    if (getRenderAheadBlocks() == preparedRenderAheadBlocks)
+        return;
+
+    suspendProcessing(true);
+    prepareToPlay(getSampleRate(), getBlockSize());
+    suspendProcessing(false);
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -300,7 +210,9 @@ bool WavetableSynthAudioProcessor::isBusesLayoutSupported (const BusesLayout& la
 
 void WavetableSynthAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    TRACE_SCOPE("processBlock");
     juce::ScopedNoDenormals noDenormals;
+    profiler.beginBlock();
     
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -309,60 +221,140 @@ void WavetableSynthAudioProcessor::processBlock (juce::AudioBuffer<float>& buffe
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
+    // RENDER AHEAD: the render thread updates, renders and publishes; only copy out here
+    if (renderAheadRenderer.isActive())
+    {
+        {
+            ScopedProfileStage profileStage(&profiler, ProfileStage::Output);
+            renderAheadRenderer.process(buffer, midiMessages, isNonRealtime());
+            pushAnalyzerSamples(buffer);
+        }
+
+        if (profiler.isActive())
+            profiler.endBlock(buffer.getNumSamples() / getSampleRate(), 0, 0);
+        return;
+    }
+
     // UPDATE
-    updateSynthesizerParametersFromValueTree();
+    {
+        ScopedProfileStage profileStage(&profiler, ProfileStage::ParameterUpdate);
+        updateSynthesizerParametersFromValueTree();
+    }
     
-    // RENDER
-    renderOversampledBlock(buffer, midiMessages);
+    // RENDER: skipped while nothing sounds and nothing arrives, the buffer is already clear
+    if (!isSilent(midiMessages, buffer.getNumSamples()))
+        renderOversampledBlock(buffer, midiMessages);
+
+    // PUBLISH
+    {
+        ScopedProfileStage profileStage(&profiler, ProfileStage::Output);
+        publishRenderState(buffer);
+        pushAnalyzerSamples(buffer);
+    }
+
+    if (profiler.isActive())
+        profiler.endBlock(buffer.getNumSamples() / getSampleRate(), synthesizer.getNumActiveVoices(), synthesizer.getNumUnisonLanes());
 }
 
 void WavetableSynthAudioProcessor::updateSynthesizerParametersFromValueTree()
 {
-    // set transposition parameters
-    auto octave = valueTree.getRawParameterValue("OCTAVE_TRANSPOSE")->load();
-    auto semitone = valueTree.getRawParameterValue("SEMITONE_TRANSPOSE")->load();
-    auto fine = valueTree.getRawParameterValue("FINE_TRANSPOSE")->load();
-    auto coarse = valueTree.getRawParameterValue("COARSE_TRANSPOSE")->load();
-    synthesizer.setTransposeValues((int) octave, (int) semitone, (int) fine, coarse);
-
-    // set adsr parameters
-    auto attack = valueTree.getRawParameterValue("ADSR_ATTACK")->load();
-    auto decay = valueTree.getRawParameterValue("ADSR_DECAY")->load();
-    auto sustain = valueTree.getRawParameterValue("ADSR_SUSTAIN")->load();
-    auto release = valueTree.getRawParameterValue("ADSR_RELEASE")->load();
-    synthesizer.setAdsrParameters(attack, decay, sustain, release);
-
-    // set mixing parameters
-    synthesizer.setVolume(valueTree.getRawParameterValue("OSC_VOLUME")->load());
-    synthesizer.setPan(valueTree.getRawParameterValue("OSC_PANNING")->load());
-
-    // set detune parameters
-    auto detuneVoices = valueTree.getRawParameterValue("OSC_DETUNE_VOICES")->load();
-    auto detuneSpread = valueTree.getRawParameterValue("OSC_DETUNE_SPREAD")->load();
-    auto detuneMix = valueTree.getRawParameterValue("OSC_DETUNE_MIX")->load();
-    synthesizer.setDetuneVoices((int) detuneVoices);
-    synthesizer.setDetuneSpread(detuneSpread);
-    synthesizer.setDetuneMix(detuneMix);
-
-    // set wavetable parameters
-    auto wavetablePositionKnobValue = valueTree.getRawParameterValue("OSC_WAVETABLE_POSITION")->load();
-    int wavetablePosition = (int) std::floor(wavetablePositionKnobValue * (std::max(0, synthesizer.getNumWavetableFrames() - 1)));
-    valueTree.getRawParameterValue("OSC_WAVETABLE_CURRENT_FRAME")->store((float) wavetablePosition);
-    synthesizer.setWavetableFrameIndex((int) valueTree.getRawParameterValue("OSC_WAVETABLE_CURRENT_FRAME")->load());
+    applySynthesizerState(synthesizer, getSynthesizerStateFromValueTree(valueTree));
+
+    // the whole profile follows the host's non-realtime flag and profile edits at once; the
+    // oversampling factor keeps the reported latency, so the swap needs no re-prepare
+    const auto renderProfile = getActiveRenderProfile();
+    oversampledRenderer.setOversamplingFactor(renderProfile.oversamplingFactor);
+    applyRenderProfile(synthesizer, renderProfile);
+}
+
+// silent once no voice is active, the block brings no midi, and the oversampling filters have
+// had SILENCE_FLUSH_SAMPLES to ring out
+bool WavetableSynthAudioProcessor::isSilent(const juce::MidiBuffer &midiMessages, int numSamples)
+{
+    const int flushSamples = (int) std::ceil(oversampledRenderer.getLatencyInSamples()) + SILENCE_FLUSH_SAMPLES;
+
+    if (!midiMessages.isEmpty() || synthesizer.getNumActiveVoices() > 0)
+    {
+        // rendering resumes from clean filters rather than whatever they held when it stopped
+        if (numSilentSamples >= flushSamples)
+            oversampledRenderer.reset();
+
+        numSilentSamples = 0;
+        return false;
+    }
+
+    if (numSilentSamples < flushSamples)
+    {
+        numSilentSamples += numSamples;
+        return false;
+    }
+
+    return true;
 }
 
 void WavetableSynthAudioProcessor::renderOversampledBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
-    juce::dsp::AudioBlock<float> block(buffer);
-    juce::dsp::AudioBlock<float> oversampledBlock = oversamplingEngine.processSamplesUp(block);
+    TRACE_SCOPE("renderOversampledBlock");
+    oversampledRenderer.process(buffer, midiMessages);
+}
 
-    float *channels[2] = {oversampledBlock.getChannelPointer(0), oversampledBlock.getChannelPointer(1)};
-    juce::AudioBuffer<float> oversampledBuffer{channels, 2, static_cast<int>(oversampledBlock.getNumSamples())};
+//==============================================================================
+void WavetableSynthAudioProcessor::publishRenderState(const juce::AudioBuffer<float> &buffer)
+{
+    auto &renderState = renderStateBuffer.getWriteBuffer();
+    synthesizer.fillRenderState(renderState);
 
-    synthesizer.setSampleRate((float) getSampleRate() * oversampleCoefficient);
-    synthesizer.processBlock(oversampledBuffer, midiMessages);
+    renderState.outputPeak = 0.f;
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    {
+        renderState.outputPeak = juce::jmax(renderState.outputPeak, buffer.getMagnitude(channel, 0, buffer.getNumSamples()));
+    }
+
+    renderStateBuffer.publish();
+}
+
+const RenderState &WavetableSynthAudioProcessor::getRenderState()
+{
+    renderStateBuffer.update();
+    return renderStateBuffer.getReadBuffer();
+}
+
+// mix the downsampled output to mono and hand it to the analyzer; never blocks,
+// samples are dropped while the analyzer view is not draining the fifo
+void WavetableSynthAudioProcessor::pushAnalyzerSamples(const juce::AudioBuffer<float> &buffer)
+{
+    if (buffer.getNumChannels() == 0 || analyzerScratch.getNumSamples() == 0)
+        return;
+
+    auto *mono = analyzerScratch.getWritePointer(0);
+    const int chunkSize = analyzerScratch.getNumSamples();
+
+    for (int startSample = 0; startSample < buffer.getNumSamples(); startSample += chunkSize)
+    {
+        const int numSamples = juce::jmin(chunkSize, buffer.getNumSamples() - startSample);
+
+        if (buffer.getNumChannels() > 1)
+        {
+            juce::FloatVectorOperations::add(mono, buffer.getReadPointer(0, startSample), buffer.getReadPointer(1, startSample), numSamples);
+            juce::FloatVectorOperations::multiply(mono, 0.5f, numSamples);
+        }
+        else
+        {
+            juce::FloatVectorOperations::copy(mono, buffer.getReadPointer(0, startSample), numSamples);
+        }
+
+        analyzerFifo.push(mono, numSamples);
+    }
+}
+
+SpscRingBuffer<float> &WavetableSynthAudioProcessor::getAnalyzerFifo()
+{
+    return analyzerFifo;
+}
 
-    oversamplingEngine.processSamplesDown(block);
+BlockProfiler &WavetableSynthAudioProcessor::getProfiler()
+{
+    return profiler;
 }
 
 //==============================================================================
@@ -400,6 +392,7 @@ void WavetableSynthAudioProcessor::setStateInformation (const void* data, int si
 juce::AudioProcessorValueTreeState::ParameterLayout WavetableSynthAudioProcessor::createParameterLayout()
 {
     juce::AudioProcessorValueTreeState::ParameterLayout layout;
+    const SynthesizerState defaults;
 
     //----------------------------------
     // TRANSPOSE PARAMETERS
@@ -409,10 +402,10 @@ juce::AudioProcessorValueTreeState::ParameterLayout WavetableSynthAudioProcessor
     auto fineTuneTransposeRange = juce::NormalisableRange<float>(-100.f, 100.f, 1.f, 1.f);
     auto coarsePitchTransposeRange = juce::NormalisableRange<float>(-48.f, 48.f, 0.01f, 1.f);
 
-    layout.add(std::make_unique<juce::AudioParameterFloat>("OCTAVE_TRANSPOSE", "OCTAVE_TRANSPOSE", octaveTransposeRange, 0.f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("SEMITONE_TRANSPOSE", "SEMITONE_TRANSPOSE", semitoneTransposeRange, 0.f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("FINE_TRANSPOSE", "FINE_TRANSPOSE", fineTuneTransposeRange, 0.f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("COARSE_TRANSPOSE", "COARSE_TRANSPOSE", coarsePitchTransposeRange, 0.f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("OCTAVE_TRANSPOSE", "OCTAVE_TRANSPOSE", octaveTransposeRange, (float) defaults.octaveTranspose));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("SEMITONE_TRANSPOSE", "SEMITONE_TRANSPOSE", semitoneTransposeRange, (float) defaults.semitoneTranspose));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("FINE_TRANSPOSE", "FINE_TRANSPOSE", fineTuneTransposeRange, (float) defaults.fineTranspose));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("COARSE_TRANSPOSE", "COARSE_TRANSPOSE", coarsePitchTransposeRange, defaults.coarseTranspose));
 
     //----------------------------------
     // ADSR PARAMETERS
@@ -422,10 +415,10 @@ juce::AudioProcessorValueTreeState::ParameterLayout WavetableSynthAudioProcessor
     auto sustainRange = juce::NormalisableRange<float>(0.0f, 1.f, 0.01f, 1.f);
     auto releaseRange = juce::NormalisableRange<float>(0.0001f, 15.f, 0.0001f, 0.15f);
 
-    layout.add(std::make_unique<juce::AudioParameterFloat>("ADSR_ATTACK", "ADSR_ATTACK", attackRange, 0.0005f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("ADSR_DECAY", "ADSR_DECAY", decayRange, 1.f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("ADSR_SUSTAIN", "ADSR_SUSTAIN", sustainRange, 1.f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("ADSR_RELEASE", "ADSR_RELEASE", releaseRange, 0.015f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("ADSR_ATTACK", "ADSR_ATTACK", attackRange, defaults.adsrAttack));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("ADSR_DECAY", "ADSR_DECAY", decayRange, defaults.adsrDecay));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("ADSR_SUSTAIN", "ADSR_SUSTAIN", sustainRange, defaults.adsrSustain));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("ADSR_RELEASE", "ADSR_RELEASE", releaseRange, defaults.adsrRelease));
 
     //----------------------------------
     // OSC PARAMETERS
@@ -433,22 +426,74 @@ juce::AudioProcessorValueTreeState::ParameterLayout WavetableSynthAudioProcessor
     auto oscVolumeRange = juce::NormalisableRange<float>(0.f, 1.f, 0.01f, 1.f);
     auto oscPanningRange = juce::NormalisableRange<float>(-1.f, 1.f, .01f, 1.f);
     auto oscDetuneMixRange = juce::NormalisableRange<float>(0.f, 1.f, 0.01f, 1.f);
-    auto oscDetuneVoiceRange = juce::NormalisableRange<float>(1.f, 16.f, 1.f, 1.f);
+    auto oscDetuneVoiceRange = juce::NormalisableRange<float>(1.f, (float) MAX_DETUNE_VOICES, 1.f, 1.f);
     auto oscDetuneSpreadRange = juce::NormalisableRange<float>(0.f, 1.f, 0.01f, 1.f);
     auto oscWarpAmountRange = juce::NormalisableRange<float>(0.f, 1.f, 0.01f, 1.f);
     auto oscWarpModeRange = juce::NormalisableRange<float>(0.f, WarpModes::NumWarpModes - 1.f, 1.f, 1.f);
     auto oscWavetablePositionRange = juce::NormalisableRange<float>(0.f, 1.f, 0.01f, 1.f);
     
-    layout.add(std::make_unique<juce::AudioParameterFloat>("OSC_VOLUME", "OSC_VOLUME", oscVolumeRange, 0.75f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("OSC_PANNING", "OSC_PANNING", oscPanningRange, 0.f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("OSC_DETUNE_MIX", "OSC_DETUNE_MIX", oscDetuneMixRange, 0.f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("OSC_DETUNE_VOICES", "OSC_DETUNE_VOICES", oscDetuneVoiceRange, 1.f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("OSC_DETUNE_SPREAD", "OSC_DETUNE_SPREAD", oscDetuneSpreadRange, 0.5f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("OSC_WARP_AMOUNT", "OSC_WARP_AMOUNT", oscWarpAmountRange, 0.f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("OSC_WARP_MODE", "OSC_WARP_MODE", oscWarpModeRange, 0.f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("OSC_WAVETABLE_POSITION", "OSC_WAVETABLE_POSITION", oscWavetablePositionRange, 0.f));
-    layout.add(std::make_unique<juce::AudioParameterInt>("OSC_WAVETABLE_NUM_FRAMES", "OSC_WAVETABLE_NUM_FRAMES", 0, 256, 0));
-    layout.add(std::make_unique<juce::AudioParameterInt>("OSC_WAVETABLE_CURRENT_FRAME", "OSC_WAVETABLE_CURRENT_FRAME", 0, 512, 0));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("OSC_VOLUME", "OSC_VOLUME", oscVolumeRange, defaults.oscVolume));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("OSC_PANNING", "OSC_PANNING", oscPanningRange, defaults.oscPanning));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("OSC_DETUNE_MIX", "OSC_DETUNE_MIX", oscDetuneMixRange, defaults.oscDetuneMix));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("OSC_DETUNE_VOICES", "OSC_DETUNE_VOICES", oscDetuneVoiceRange, (float) defaults.oscDetuneVoices));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("OSC_DETUNE_SPREAD", "OSC_DETUNE_SPREAD", oscDetuneSpreadRange, defaults.oscDetuneSpread));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("OSC_WARP_AMOUNT", "OSC_WARP_AMOUNT", oscWarpAmountRange, defaults.oscWarpAmount));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("OSC_WARP_MODE", "OSC_WARP_MODE", oscWarpModeRange, (float) defaults.oscWarpMode));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("OSC_WAVETABLE_POSITION", "OSC_WAVETABLE_POSITION", oscWavetablePositionRange, defaults.oscWavetablePosition));
+    layout.add(std::make_unique<juce::AudioParameterInt>("OSC_WAVETABLE_NUM_FRAMES", "OSC_WAVETABLE_NUM_FRAMES", 0, 256, defaults.oscWavetableNumFrames));
+    layout.add(std::make_unique<juce::AudioParameterInt>("OSC_WAVETABLE_CURRENT_FRAME", "OSC_WAVETABLE_CURRENT_FRAME", 0, 512, defaults.oscWavetableCurrentFrame));
+
+    //----------------------------------
+    // FILTER PARAMETERS
+
+    auto filterModeRange = juce::NormalisableRange<float>(0.f, FilterModes::NumFilterModes - 1.f, 1.f, 1.f);
+    auto filterCutoffRange = juce::NormalisableRange<float>(20.f, 20000.f, 0.01f, 0.25f);
+    auto filterResonanceRange = juce::NormalisableRange<float>(0.f, 1.f, 0.01f, 1.f);
+    auto filterEnvelopeAmountRange = juce::NormalisableRange<float>(-1.f, 1.f, 0.01f, 1.f);
+    auto filterKeyTrackingRange = juce::NormalisableRange<float>(0.f, 1.f, 0.01f, 1.f);
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>("FILTER_MODE", "FILTER_MODE", filterModeRange, (float) defaults.filterMode));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("FILTER_CUTOFF", "FILTER_CUTOFF", filterCutoffRange, defaults.filterCutoff));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("FILTER_RESONANCE", "FILTER_RESONANCE", filterResonanceRange, defaults.filterResonance));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("FILTER_ENVELOPE_AMOUNT", "FILTER_ENVELOPE_AMOUNT", filterEnvelopeAmountRange, defaults.filterEnvelopeAmount));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("FILTER_KEY_TRACKING", "FILTER_KEY_TRACKING", filterKeyTrackingRange, defaults.filterKeyTracking));
+
+    //----------------------------------
+    // VOICE PARAMETERS
+
+    auto voiceSilenceThresholdRange = juce::NormalisableRange<float>(MIN_VOICE_SILENCE_THRESHOLD_DB, -48.f, 1.f, 1.f);
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>("VOICE_SILENCE_THRESHOLD", "VOICE_SILENCE_THRESHOLD", voiceSilenceThresholdRange, defaults.voiceSilenceThreshold));
+
+    //----------------------------------
+    // ENGINE PARAMETERS
+
+    // blocks rendered ahead of the host, 0 renders inside the callback; changes the latency
+    layout.add(std::make_unique<juce::AudioParameterInt>(juce::ParameterID("RENDER_AHEAD_BLOCKS", 1), "RENDER_AHEAD_BLOCKS", 0, MAX_RENDER_AHEAD_BLOCKS, 0, juce::AudioParameterIntAttributes().withAutomatable(false)));
+
+    //----------------------------------
+    // RENDER PROFILE PARAMETERS
+
+    // one set per profile, saved with the plugin state; the active one follows the host's non-realtime flag
+    juce::StringArray interpolationChoices;
+    for (int mode = 0; mode < NumInterpolationModes; mode++)
+        interpolationChoices.add(getInterpolationModeName(mode));
+
+    for (int profile = 0; profile < NumRenderProfiles; profile++)
+    {
+        const auto profileDefaults = getDefaultRenderProfile(profile);
+        auto parameterId = [profile](int setting) { return juce::ParameterID(getRenderProfileParameterId(profile, setting), 1); };
+        auto parameterName = [profile](int setting) { return juce::String(getRenderProfileParameterId(profile, setting)); };
+
+        layout.add(std::make_unique<juce::AudioParameterChoice>(parameterId(RenderProfileOversampling), parameterName(RenderProfileOversampling), getOversamplingChoices(),
+                                                                getOversamplingChoiceIndex(profileDefaults.oversamplingFactor), juce::AudioParameterChoiceAttributes().withAutomatable(false)));
+        layout.add(std::make_unique<juce::AudioParameterChoice>(parameterId(RenderProfileInterpolation), parameterName(RenderProfileInterpolation), interpolationChoices,
+                                                                profileDefaults.interpolationMode, juce::AudioParameterChoiceAttributes().withAutomatable(false)));
+        layout.add(std::make_unique<juce::AudioParameterInt>(parameterId(RenderProfileUnisonCap), parameterName(RenderProfileUnisonCap), 1, MAX_DETUNE_VOICES,
+                                                             profileDefaults.unisonVoiceLimit, juce::AudioParameterIntAttributes().withAutomatable(false)));
+        layout.add(std::make_unique<juce::AudioParameterBool>(parameterId(RenderProfileMultithreaded), parameterName(RenderProfileMultithreaded),
+                                                              profileDefaults.multithreaded, juce::AudioParameterBoolAttributes().withAutomatable(false)));
+    }
 
     return layout;
 }
@@ -13,6 +13,19 @@
 #include "Synthesizer/Oscillator.h"
 #include "Synthesizer/Synthesizer.h"
 #include "Synthesizer/SynthesizerState.h"
+#include "Synthesizer/RenderProfile.h"
+#include "Synthesizer/RenderState.h"
+#include "Synthesizer/OversampledRenderer.h"
+#include "Synthesizer/RenderAheadRenderer.h"
+#include "Synthesizer/WavetableGenerators.h"
+#include "Utilities/TripleBuffer.h"
+#include "Utilities/SpscRingBuffer.h"
+#include "Utilities/BlockProfiler.h"
+#include "Utilities/TraceRecorder.h"
+#include "Utilities/WorkerPool.h"
+
+// output samples still rendered after the last voice ends, so the oversampling filters ring out
+#define SILENCE_FLUSH_SAMPLES 1024
 
 #define BODY_COLOR_HEX              0xFF64BEA5
 #define BORDER_COLOR_HEX            0xFF0F1D1F
@@ -20,16 +33,10 @@
 #define SCREEN_SHADOW_COLOR_HEX     0xFFB1E7CC
 #define CONTROL_SURFACE_COLOR_HEX   0xFF528187
 
-void generateSineWavetable(Wavetable& tableToFill, int resolution);
-void generateSquareWavetable(Wavetable& tableToFill, int resolution);
-void generateSawWavetable(Wavetable& tableToFill, int resolution);
-void generateMultiSineWavetable(Wavetable& tableToFill, int resolution, int coefficientA, int coefficientB);
-void generateRandomSineCombinations(Wavetable &tableToFill);
-void generateSineFrames(Wavetable &tableToFill, int resolution);
-void generateManySineFrames(Wavetable &);
-
 //==============================================================================
-class WavetableSynthAudioProcessor  : public juce::AudioProcessor
+class WavetableSynthAudioProcessor  : public juce::AudioProcessor,
+                                      private juce::AudioProcessorValueTreeState::Listener,
+                                      private juce::AsyncUpdater
 {
 public:
     //==============================================================================
@@ -48,6 +55,16 @@ public:
 
     void updateSynthesizerParametersFromValueTree();
     void renderOversampledBlock(juce::AudioBuffer<float> &buffer, juce::MidiBuffer &midiMessages);
+    bool isSilent(const juce::MidiBuffer &midiMessages, int numSamples);
+
+    // message thread only: latest render state published by the audio thread
+    const RenderState &getRenderState();
+
+    // message thread only: mono output samples for the analyzer view
+    SpscRingBuffer<float> &getAnalyzerFifo();
+
+    // per-stage timings for the performance overlay, only collected while it is enabled
+    BlockProfiler &getProfiler();
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -81,8 +98,39 @@ public:
     Oscillator osc;
 
 private:
-    const int oversampleCoefficient = 16;
-    juce::dsp::Oversampling<float> oversamplingEngine;
+    OversampledRenderer oversampledRenderer{ synthesizer };
+
+    // the realtime or offline profile, whichever matches the host's non-realtime flag
+    RenderProfile getActiveRenderProfile();
+
+    // opt-in: renders on a dedicated thread ahead of the host, for a reported extra latency
+    RenderAheadRenderer renderAheadRenderer{ oversampledRenderer };
+    int preparedRenderAheadBlocks = 0;
+    int getRenderAheadBlocks() const;
+
+    // output samples since the last block with an active voice or incoming midi
+    int numSilentSamples = 0;
+
+    // changing the latency re-prepares the processor, which happens on the message thread
+    void parameterChanged(const juce::String &parameterID, float newValue) override;
+    void handleAsyncUpdate() override;
+
+    TripleBuffer<RenderState> renderStateBuffer;
+    void publishRenderState(const juce::AudioBuffer<float> &buffer);
+
+    SpscRingBuffer<float> analyzerFifo;
+    juce::AudioBuffer<float> analyzerScratch;
+    void pushAnalyzerSamples(const juce::AudioBuffer<float> &buffer);
+
+    BlockProfiler profiler;
+
+    // one set of render threads for every instance in the process
+    juce::SharedResourcePointer<WorkerPool> workerPool;
+
+   #if WAVETABLESYNTH_TRACING
+    // shared by every instance in the process, writes one trace file per session
+    juce::SharedResourcePointer<TraceRecorder> traceRecorder;
+   #endif
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WavetableSynthAudioProcessor)
@@ -0,0 +1,168 @@
+#include "AdsrEnvelope.h"
+
+//=============================================================================
+// CONSTRUCTORS / DESTRUCTORS
+
+AdsrEnvelope::AdsrEnvelope()
+{
+    state = StateIdle;
+    sampleRate = 44100.0;
+
+    level = 0.f;
+    attackRate = 0.f;
+    decayRate = 0.f;
+    releaseRate = 0.f;
+
+    recalculateRates();
+}
+
+AdsrEnvelope::~AdsrEnvelope() {}
+
+//=============================================================================
+// PARAMETERS
+
+void AdsrEnvelope::setParameters(const juce::ADSR::Parameters &newParameters)
+{
+    parameters = newParameters;
+    recalculateRates();
+}
+
+void AdsrEnvelope::setSampleRate(double newSampleRate)
+{
+    jassert(newSampleRate > 0.0);
+    sampleRate = newSampleRate;
+    recalculateRates();
+}
+
+// a zero length stage has no rate and is skipped. the release rate is reset to fall from
+// the sustain level, as juce::ADSR does, so a parameter change mid-release changes its slope
+void AdsrEnvelope::recalculateRates()
+{
+    auto getRate = [this](float distance, float timeInSeconds) {
+        return timeInSeconds > 0.f ? (float) (distance / (timeInSeconds * sampleRate)) : -1.f;
+    };
+
+    attackRate = getRate(1.f, parameters.attack);
+    decayRate = getRate(1.f - parameters.sustain, parameters.decay);
+    releaseRate = getRate(parameters.sustain, parameters.release);
+
+    if ((state == StateAttack && attackRate <= 0.f)
+        || (state == StateDecay && (decayRate <= 0.f || level <= parameters.sustain))
+        || (state == StateRelease && releaseRate <= 0.f))
+    {
+        goToNextState();
+    }
+}
+
+//=============================================================================
+// STATE
+
+void AdsrEnvelope::noteOn()
+{
+    if (attackRate > 0.f)
+    {
+        state = StateAttack;
+    }
+    else if (decayRate > 0.f)
+    {
+        level = 1.f;
+        state = StateDecay;
+    }
+    else
+    {
+        level = parameters.sustain;
+        state = StateSustain;
+    }
+}
+
+// the release falls from wherever the envelope is to zero in the release time
+void AdsrEnvelope::noteOff()
+{
+    if (state == StateIdle)
+        return;
+
+    if (parameters.release > 0.f)
+    {
+        releaseRate = (float) (level / (parameters.release * sampleRate));
+        state = StateRelease;
+    }
+    else
+    {
+        reset();
+    }
+}
+
+void AdsrEnvelope::reset()
+{
+    level = 0.f;
+    state = StateIdle;
+}
+
+bool AdsrEnvelope::isActive() const
+{
+    return state != StateIdle;
+}
+
+void AdsrEnvelope::goToNextState()
+{
+    if (state == StateAttack)
+        state = decayRate > 0.f ? StateDecay : StateSustain;
+    else if (state == StateDecay)
+        state = StateSustain;
+    else if (state == StateRelease)
+        reset();
+}
+
+//=============================================================================
+// RENDER
+
+// every moving stage is a straight line to its target, so a block is at most a few ramp fills.
+// the sample that reaches the target is written as the target, and the next stage starts after it
+void AdsrEnvelope::render(float *output, int numSamples, const DspKernels &kernels)
+{
+    int sample = 0;
+    while (sample < numSamples)
+    {
+        const int samplesLeft = numSamples - sample;
+
+        if (state == StateIdle || state == StateSustain)
+        {
+            if (state == StateSustain)
+                level = parameters.sustain;
+
+            juce::FloatVectorOperations::fill(output + sample, level, samplesLeft);
+            return;
+        }
+
+        float target = 0.f;
+        float step = -releaseRate;
+        if (state == StateAttack)
+        {
+            target = 1.f;
+            step = attackRate;
+        }
+        else if (state == StateDecay)
+        {
+            target = parameters.sustain;
+            step = -decayRate;
+        }
+
+        // a level already past the target finishes the stage on the next sample
+        const double samplesToTarget = juce::jmax(1.0, std::ceil((double) (target - level) / (double) step));
+        const bool reachesTarget = samplesToTarget <= (double) samplesLeft;
+        const int length = reachesTarget ? (int) samplesToTarget : samplesLeft;
+
+        kernels.fillRamp(output + sample, level, step, length);
+        sample += length;
+
+        if (!reachesTarget)
+        {
+            level = output[sample - 1];
+            return;
+        }
+
+        level = target;
+        output[sample - 1] = target;
+        goToNextState();
+    }
+}
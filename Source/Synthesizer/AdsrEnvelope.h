@@ -0,0 +1,57 @@
+#ifndef ADSR_ENVELOPE_H
+#define ADSR_ENVELOPE_H
+
+#include <JuceHeader.h>
+#include "DspKernels.h"
+
+// the linear attack, decay, sustain, release envelope of juce::ADSR, with the same states,
+// rates and retriggering, rendered a block at a time: each linear segment is one ramp fill
+// through the dsp kernels instead of a branch per sample
+class AdsrEnvelope
+{
+public:
+
+	//=============================================================================
+	AdsrEnvelope();
+	~AdsrEnvelope();
+
+	//=============================================================================
+	void setParameters(const juce::ADSR::Parameters &);
+	void setSampleRate(double);
+
+	void noteOn();
+	void noteOff();
+	void reset();
+
+	bool isActive() const;
+
+	//=============================================================================
+	// writes the next numSamples envelope values
+	void render(float *output, int numSamples, const DspKernels &kernels);
+
+private:
+	//=============================================================================
+	enum State
+	{
+		StateIdle = 0,
+		StateAttack,
+		StateDecay,
+		StateSustain,
+		StateRelease
+	};
+
+	State state;
+	juce::ADSR::Parameters parameters;
+	double sampleRate;
+
+	float level;
+	float attackRate;
+	float decayRate;
+	float releaseRate;
+
+	//=============================================================================
+	void recalculateRates();
+	void goToNextState();
+};
+
+#endif // ADSR_ENVELOPE_H
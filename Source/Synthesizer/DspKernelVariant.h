@@ -0,0 +1,127 @@
+// no include guard: DspKernels.cpp includes this once per instruction set, with
+// DSP_KERNEL_NAMESPACE naming the variant and DSP_KERNEL_TARGET the attribute that
+// compiles its functions for that set. the loops are plain so each target vectorizes them
+// at its own width
+
+namespace DSP_KERNEL_NAMESPACE
+{
+
+//=============================================================================
+// ENVELOPE
+
+static DSP_KERNEL_TARGET void fillRamp(float *output, float start, float step, int numSamples)
+{
+    for (int sample = 0; sample < numSamples; sample++)
+        output[sample] = start + step * (float) (sample + 1);
+}
+
+static DSP_KERNEL_TARGET void applyGain(float *gains, const float *ramp, float gain, int numSamples)
+{
+    if (ramp != nullptr)
+    {
+        for (int sample = 0; sample < numSamples; sample++)
+            gains[sample] = gains[sample] * ramp[sample] * gain;
+    }
+    else
+    {
+        for (int sample = 0; sample < numSamples; sample++)
+            gains[sample] = gains[sample] * gain;
+    }
+}
+
+//=============================================================================
+// MIXING
+
+static DSP_KERNEL_TARGET void mixMono(float *output, const float *samples, const float *gains, float gain, int numSamples)
+{
+    for (int sample = 0; sample < numSamples; sample++)
+        output[sample] += samples[sample] * gains[sample] * gain;
+}
+
+static DSP_KERNEL_TARGET void mixStereo(float *left, float *right, const float *samples, const float *gains, float gainLeft, float gainRight, int numSamples)
+{
+    for (int sample = 0; sample < numSamples; sample++)
+    {
+        const float sampleValue = samples[sample] * gains[sample];
+        left[sample] += sampleValue * gainLeft;
+        right[sample] += sampleValue * gainRight;
+    }
+}
+
+static DSP_KERNEL_TARGET void mixMidSide(float *left, float *right, const float *mid, const float *side, const float *gains,
+                                         const float *cosTheta, const float *sinTheta, int numSamples)
+{
+    for (int sample = 0; sample < numSamples; sample++)
+    {
+        const float cosGain = cosTheta[sample] * gains[sample];
+        const float sinGain = sinTheta[sample] * gains[sample];
+        left[sample] += cosGain * mid[sample] - sinGain * side[sample];
+        right[sample] += sinGain * mid[sample] + cosGain * side[sample];
+    }
+}
+
+static DSP_KERNEL_TARGET void mixMidSideConstant(float *left, float *right, const float *mid, const float *side, const float *gains,
+                                                 float cosTheta, float sinTheta, int numSamples)
+{
+    for (int sample = 0; sample < numSamples; sample++)
+    {
+        const float cosGain = cosTheta * gains[sample];
+        const float sinGain = sinTheta * gains[sample];
+        left[sample] += cosGain * mid[sample] - sinGain * side[sample];
+        right[sample] += sinGain * mid[sample] + cosGain * side[sample];
+    }
+}
+
+static DSP_KERNEL_TARGET void add(float *output, const float *input, int numSamples)
+{
+    for (int sample = 0; sample < numSamples; sample++)
+        output[sample] += input[sample];
+}
+
+//=============================================================================
+// OSCILLATOR
+
+// the loops themselves live in Interpolation.h, shared with the scalar block kernels
+template <typename Interpolation>
+static DSP_KERNEL_TARGET float renderBlock(const float *values, int tableSize, float phase, float phaseIncrement, float *output, int numSamples)
+{
+    return renderInterpolatedBlock<Interpolation>(values, tableSize, phase, phaseIncrement, output, numSamples);
+}
+
+template <typename Interpolation, bool hasSide>
+static DSP_KERNEL_TARGET void accumulateUnison(const float *values, int tableSize, float *phases, const float *phaseIncrements,
+                                               const float *gainsMid, const float *gainsSide, int numVoices,
+                                               float *mid, float *side, int numSamples)
+{
+    accumulateUnisonBlock<Interpolation, hasSide>(values, tableSize, phases, phaseIncrements, gainsMid, gainsSide, numVoices, mid, side, numSamples);
+}
+
+static const DspKernels kernels = {
+    DSP_KERNEL_ISA,
+    DSP_KERNEL_NAME,
+    fillRamp,
+    applyGain,
+    mixMono,
+    mixStereo,
+    mixMidSide,
+    mixMidSideConstant,
+    add,
+    {
+        renderBlock<LinearInterpolation>,
+        renderBlock<HermiteInterpolation>,
+        renderBlock<Hermite6Interpolation>,
+        renderBlock<SincInterpolation<8>>,
+        renderBlock<SincInterpolation<16>>,
+        renderBlock<SincInterpolation<32>>
+    },
+    {
+        { accumulateUnison<LinearInterpolation, false>,    accumulateUnison<LinearInterpolation, true> },
+        { accumulateUnison<HermiteInterpolation, false>,   accumulateUnison<HermiteInterpolation, true> },
+        { accumulateUnison<Hermite6Interpolation, false>,  accumulateUnison<Hermite6Interpolation, true> },
+        { accumulateUnison<SincInterpolation<8>, false>,   accumulateUnison<SincInterpolation<8>, true> },
+        { accumulateUnison<SincInterpolation<16>, false>,  accumulateUnison<SincInterpolation<16>, true> },
+        { accumulateUnison<SincInterpolation<32>, false>,  accumulateUnison<SincInterpolation<32>, true> }
+    }
+};
+
+} // namespace DSP_KERNEL_NAMESPACE
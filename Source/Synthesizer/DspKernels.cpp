@@ -0,0 +1,291 @@
+#include "DspKernels.h"
+
+// the wider variants need per-function target attributes, which only gcc and clang have;
+// elsewhere the baseline is the only variant
+#if JUCE_INTEL && (JUCE_GCC || JUCE_CLANG)
+ #define DSP_KERNELS_HAVE_ISA_VARIANTS 1
+#else
+ #define DSP_KERNELS_HAVE_ISA_VARIANTS 0
+#endif
+
+#define DSP_KERNEL_SELF_TEST_SAMPLES 1027
+#define DSP_KERNEL_SELF_TEST_TABLE_SIZE 2048
+#define DSP_KERNEL_SELF_TEST_SEED 0x15a
+#define DSP_KERNEL_SELF_TEST_UNISON_VOICES 12
+
+//=============================================================================
+// VARIANTS
+
+#define DSP_KERNEL_NAMESPACE baselineKernels
+#define DSP_KERNEL_TARGET
+#define DSP_KERNEL_ISA DspIsaBaseline
+#define DSP_KERNEL_NAME "baseline"
+#include "DspKernelVariant.h"
+#undef DSP_KERNEL_NAMESPACE
+#undef DSP_KERNEL_TARGET
+#undef DSP_KERNEL_ISA
+#undef DSP_KERNEL_NAME
+
+#if DSP_KERNELS_HAVE_ISA_VARIANTS
+
+#define DSP_KERNEL_NAMESPACE sse41Kernels
+#define DSP_KERNEL_TARGET __attribute__((target("sse4.1")))
+#define DSP_KERNEL_ISA DspIsaSse41
+#define DSP_KERNEL_NAME "sse4.1"
+#include "DspKernelVariant.h"
+#undef DSP_KERNEL_NAMESPACE
+#undef DSP_KERNEL_TARGET
+#undef DSP_KERNEL_ISA
+#undef DSP_KERNEL_NAME
+
+#define DSP_KERNEL_NAMESPACE avx2Kernels
+#define DSP_KERNEL_TARGET __attribute__((target("avx2,fma")))
+#define DSP_KERNEL_ISA DspIsaAvx2
+#define DSP_KERNEL_NAME "avx2"
+#include "DspKernelVariant.h"
+#undef DSP_KERNEL_NAMESPACE
+#undef DSP_KERNEL_TARGET
+#undef DSP_KERNEL_ISA
+#undef DSP_KERNEL_NAME
+
+#define DSP_KERNEL_NAMESPACE avx512Kernels
+#define DSP_KERNEL_TARGET __attribute__((target("avx512f,avx512vl,avx2,fma")))
+#define DSP_KERNEL_ISA DspIsaAvx512
+#define DSP_KERNEL_NAME "avx512"
+#include "DspKernelVariant.h"
+#undef DSP_KERNEL_NAMESPACE
+#undef DSP_KERNEL_TARGET
+#undef DSP_KERNEL_ISA
+#undef DSP_KERNEL_NAME
+
+#endif
+
+//=============================================================================
+// SELECTION
+
+static bool cpuCanRun(DspIsa isa)
+{
+    switch (isa)
+    {
+        case DspIsaBaseline: return true;
+        case DspIsaSse41:    return juce::SystemStats::hasSSE41();
+        case DspIsaAvx2:     return juce::SystemStats::hasAVX2() && juce::SystemStats::hasFMA3();
+        case DspIsaAvx512:   return juce::SystemStats::hasAVX512F() && juce::SystemStats::hasAVX512VL();
+        default:             return false;
+    }
+}
+
+static const DspKernels *getCompiledKernels(DspIsa isa)
+{
+    switch (isa)
+    {
+        case DspIsaBaseline: return &baselineKernels::kernels;
+       #if DSP_KERNELS_HAVE_ISA_VARIANTS
+        case DspIsaSse41:    return &sse41Kernels::kernels;
+        case DspIsaAvx2:     return &avx2Kernels::kernels;
+        case DspIsaAvx512:   return &avx512Kernels::kernels;
+       #endif
+        default:             return nullptr;
+    }
+}
+
+const DspKernels *getDspKernels(DspIsa isa)
+{
+    return cpuCanRun(isa) ? getCompiledKernels(isa) : nullptr;
+}
+
+DspIsa parseDspIsa(const juce::String &name, DspIsa fallback)
+{
+    for (int isa = 0; isa < NumDspIsas; isa++)
+    {
+        if (auto *kernels = getCompiledKernels((DspIsa) isa))
+            if (name.trim().equalsIgnoreCase(kernels->name))
+                return (DspIsa) isa;
+    }
+
+    return fallback;
+}
+
+static const DspKernels &selectDspKernels()
+{
+    const auto *selected = &baselineKernels::kernels;
+    for (int isa = 0; isa < NumDspIsas; isa++)
+    {
+        if (auto *kernels = getDspKernels((DspIsa) isa))
+            selected = kernels;
+    }
+
+    // an override this cpu cannot run falls back to the automatic choice
+    const auto overrideName = juce::SystemStats::getEnvironmentVariable(DSP_ISA_ENVIRONMENT_VARIABLE, {});
+    if (overrideName.isNotEmpty())
+    {
+        if (auto *kernels = getDspKernels(parseDspIsa(overrideName, selected->isa)))
+            selected = kernels;
+    }
+
+   #if JUCE_DEBUG
+    juce::String failureMessage;
+    jassert(runDspKernelSelfTest(failureMessage));
+   #endif
+
+    return *selected;
+}
+
+const DspKernels &getDspKernels()
+{
+    static const DspKernels &kernels = selectDspKernels();
+    return kernels;
+}
+
+//=============================================================================
+// SELF-TEST
+
+static bool outputsMatch(const std::vector<float> &expected, const std::vector<float> &actual, const juce::String &kernelName,
+                         const DspKernels &variant, juce::String &failureMessage)
+{
+    for (size_t sample = 0; sample < expected.size(); sample++)
+    {
+        if (std::abs(expected[sample] - actual[sample]) > DSP_KERNEL_SELF_TEST_TOLERANCE)
+        {
+            failureMessage = kernelName + " (" + variant.name + ") differs from baseline at sample " + juce::String((int) sample)
+                           + ": " + juce::String(actual[sample], 7) + " instead of " + juce::String(expected[sample], 7);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// every kernel gets the same random input; outputs start from the same random contents, so
+// the accumulating kernels are checked too
+bool runDspKernelSelfTest(juce::String &failureMessage)
+{
+    const int numSamples = DSP_KERNEL_SELF_TEST_SAMPLES;
+    juce::Random random(DSP_KERNEL_SELF_TEST_SEED);
+
+    auto makeSignal = [&random](int size, float lowest, float highest) {
+        std::vector<float> signal((size_t) size);
+        for (auto &value : signal)
+            value = lowest + (highest - lowest) * random.nextFloat();
+        return signal;
+    };
+
+    const auto table = makeSignal(DSP_KERNEL_SELF_TEST_TABLE_SIZE, -1.f, 1.f);
+    const auto samples = makeSignal(numSamples, -1.f, 1.f);
+    const auto side = makeSignal(numSamples, -1.f, 1.f);
+    const auto gains = makeSignal(numSamples, 0.f, 1.f);
+    const auto ramp = makeSignal(numSamples, 0.f, 1.f);
+    const auto cosTheta = makeSignal(numSamples, 0.f, 1.f);
+    const auto sinTheta = makeSignal(numSamples, 0.f, 1.f);
+    const auto initialLeft = makeSignal(numSamples, -1.f, 1.f);
+    const auto initialRight = makeSignal(numSamples, -1.f, 1.f);
+    const auto unisonPhases = makeSignal(DSP_KERNEL_SELF_TEST_UNISON_VOICES, 0.f, 1.f);
+    const auto unisonPhaseIncrements = makeSignal(DSP_KERNEL_SELF_TEST_UNISON_VOICES, 0.f, 0.05f);
+    const auto unisonGainsMid = makeSignal(DSP_KERNEL_SELF_TEST_UNISON_VOICES, 0.f, 1.f);
+    const auto unisonGainsSide = makeSignal(DSP_KERNEL_SELF_TEST_UNISON_VOICES, -1.f, 1.f);
+
+    // [kernel][channel] outputs of one variant
+    auto render = [&](const DspKernels &kernels) {
+        std::vector<std::vector<float>> outputs;
+
+        std::vector<float> envelope((size_t) numSamples);
+        kernels.fillRamp(envelope.data(), 0.3f, 0.0007f, numSamples);
+        outputs.push_back(envelope);
+
+        auto scaled = gains;
+        kernels.applyGain(scaled.data(), ramp.data(), 0.7f, numSamples);
+        outputs.push_back(scaled);
+
+        scaled = gains;
+        kernels.applyGain(scaled.data(), nullptr, 0.7f, numSamples);
+        outputs.push_back(scaled);
+
+        auto left = initialLeft;
+        kernels.mixMono(left.data(), samples.data(), gains.data(), 0.6f, numSamples);
+        outputs.push_back(left);
+
+        left = initialLeft;
+        auto right = initialRight;
+        kernels.mixStereo(left.data(), right.data(), samples.data(), gains.data(), 0.8f, 0.3f, numSamples);
+        outputs.push_back(left);
+        outputs.push_back(right);
+
+        left = initialLeft;
+        right = initialRight;
+        kernels.mixMidSide(left.data(), right.data(), samples.data(), side.data(), gains.data(), cosTheta.data(), sinTheta.data(), numSamples);
+        outputs.push_back(left);
+        outputs.push_back(right);
+
+        left = initialLeft;
+        right = initialRight;
+        kernels.mixMidSideConstant(left.data(), right.data(), samples.data(), side.data(), gains.data(), 0.9f, 0.4f, numSamples);
+        outputs.push_back(left);
+        outputs.push_back(right);
+
+        left = initialLeft;
+        kernels.add(left.data(), samples.data(), numSamples);
+        outputs.push_back(left);
+
+        for (int mode = 0; mode < NumInterpolationModes; mode++)
+        {
+            std::vector<float> rendered((size_t) numSamples);
+            const float phase = kernels.renderBlock[mode](table.data(), DSP_KERNEL_SELF_TEST_TABLE_SIZE, 0.25f, 0.0123f, rendered.data(), numSamples);
+            rendered.push_back(phase);
+            outputs.push_back(rendered);
+        }
+
+        // mid, side and the phases after the block, for each mode with and without a side sum
+        for (int mode = 0; mode < NumInterpolationModes; mode++)
+        {
+            for (int hasSide = 0; hasSide < 2; hasSide++)
+            {
+                auto phases = unisonPhases;
+                std::vector<float> mid((size_t) numSamples);
+                std::vector<float> unisonSide((size_t) numSamples);
+                kernels.accumulateUnison[mode][hasSide](table.data(), DSP_KERNEL_SELF_TEST_TABLE_SIZE, phases.data(), unisonPhaseIncrements.data(),
+                                                        unisonGainsMid.data(), unisonGainsSide.data(), DSP_KERNEL_SELF_TEST_UNISON_VOICES,
+                                                        mid.data(), unisonSide.data(), numSamples);
+                outputs.push_back(mid);
+                outputs.push_back(unisonSide);
+                outputs.push_back(phases);
+            }
+        }
+
+        return outputs;
+    };
+
+    std::vector<juce::String> outputNames = { "fillRamp", "applyGain ramp", "applyGain", "mixMono", "mixStereo left", "mixStereo right",
+                                              "mixMidSide left", "mixMidSide right", "mixMidSideConstant left", "mixMidSideConstant right",
+                                              "add" };
+    for (int mode = 0; mode < NumInterpolationModes; mode++)
+        outputNames.push_back(juce::String("renderBlock ") + getInterpolationModeName(mode));
+    for (int mode = 0; mode < NumInterpolationModes; mode++)
+    {
+        for (auto *layout : { " mono", " side" })
+        {
+            const auto name = juce::String("accumulateUnison ") + getInterpolationModeName(mode) + layout;
+            outputNames.push_back(name + " mid");
+            outputNames.push_back(name + " side");
+            outputNames.push_back(name + " phases");
+        }
+    }
+
+    const auto expected = render(baselineKernels::kernels);
+    jassert(expected.size() == outputNames.size());
+
+    for (int isa = DspIsaBaseline + 1; isa < NumDspIsas; isa++)
+    {
+        const auto *variant = getDspKernels((DspIsa) isa);
+        if (variant == nullptr)
+            continue;
+
+        const auto actual = render(*variant);
+        for (size_t output = 0; output < expected.size(); output++)
+        {
+            if (!outputsMatch(expected[output], actual[output], outputNames[output], *variant, failureMessage))
+                return false;
+        }
+    }
+
+    return true;
+}
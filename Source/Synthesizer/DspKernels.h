@@ -0,0 +1,70 @@
+#ifndef DSP_KERNELS_H
+#define DSP_KERNELS_H
+
+#include <JuceHeader.h>
+#include "Interpolation.h"
+
+// forces one variant when set: baseline, sse4.1, avx2 or avx512
+#define DSP_ISA_ENVIRONMENT_VARIABLE "WAVETABLESYNTH_DSP_ISA"
+
+// largest difference the self-test accepts between a variant and the baseline
+#define DSP_KERNEL_SELF_TEST_TOLERANCE 1.0e-5f
+
+enum DspIsa {
+	DspIsaBaseline = 0,
+	DspIsaSse41,
+	DspIsaAvx2,
+	DspIsaAvx512,
+	NumDspIsas
+};
+
+// the inner loops of the render path, compiled once per instruction set. every variant
+// computes the same thing; the wider ones may fuse multiply-adds, so they agree to rounding
+struct DspKernels
+{
+	DspIsa isa;
+	const char *name;
+
+	// envelope: output[i] = start + step * (i + 1), one linear segment
+	void (*fillRamp)(float *output, float start, float step, int numSamples);
+
+	// gains[i] *= ramp[i] * gain, or gains[i] *= gain when ramp is nullptr
+	void (*applyGain)(float *gains, const float *ramp, float gain, int numSamples);
+
+	// mixing: output[i] += samples[i] * gains[i] * gain, once per channel for stereo
+	void (*mixMono)(float *output, const float *samples, const float *gains, float gain, int numSamples);
+	void (*mixStereo)(float *left, float *right, const float *samples, const float *gains, float gainLeft, float gainRight, int numSamples);
+
+	// mid/side sums rotated to the base pan, with the pan moving or fixed over the block
+	void (*mixMidSide)(float *left, float *right, const float *mid, const float *side, const float *gains,
+	                   const float *cosTheta, const float *sinTheta, int numSamples);
+	void (*mixMidSideConstant)(float *left, float *right, const float *mid, const float *side, const float *gains,
+	                           float cosTheta, float sinTheta, int numSamples);
+
+	// output[i] += input[i]
+	void (*add)(float *output, const float *input, int numSamples);
+
+	// oscillator: one voice at a fixed phase increment, indexed by InterpolationModes
+	InterpolationBlockKernel renderBlock[NumInterpolationModes];
+
+	// unison voices summed across SIMD lanes, indexed by InterpolationModes and then by
+	// whether a side sum is wanted
+	UnisonBlockKernel accumulateUnison[NumInterpolationModes][2];
+};
+
+//=============================================================================
+// the variant every render path uses, chosen on the first call: the environment override
+// when it names a variant this cpu can run, otherwise the widest one it can. call it once off
+// the audio thread before rendering starts, as the oscillator constructor does
+const DspKernels &getDspKernels();
+
+// nullptr when the variant was not compiled in or this cpu cannot run it
+const DspKernels *getDspKernels(DspIsa);
+
+DspIsa parseDspIsa(const juce::String &name, DspIsa fallback);
+
+// runs every kernel of every runnable variant on the same input and compares it with the
+// baseline; on a mismatch returns false and says where in failureMessage
+bool runDspKernelSelfTest(juce::String &failureMessage);
+
+#endif // DSP_KERNELS_H
@@ -0,0 +1,185 @@
+#include "Interpolation.h"
+
+//=============================================================================
+// MODES
+
+const char *getInterpolationModeName(int mode)
+{
+    switch (mode)
+    {
+        case InterpolationLinear:   return "linear";
+        case InterpolationHermite:  return "hermite";
+        case InterpolationHermite6: return "hermite6";
+        case InterpolationSinc8:    return "sinc8";
+        case InterpolationSinc16:   return "sinc16";
+        case InterpolationSinc32:   return "sinc32";
+        default:                    return "unknown";
+    }
+}
+
+int parseInterpolationMode(const juce::String &name, int fallback)
+{
+    for (int mode = 0; mode < NumInterpolationModes; mode++)
+    {
+        if (name.trim().equalsIgnoreCase(getInterpolationModeName(mode)))
+            return mode;
+    }
+
+    return fallback;
+}
+
+//=============================================================================
+// WINDOWED SINC
+
+// zeroth order modified bessel function of the first kind, by its power series
+static double besselI0(double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 32; k++)
+    {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+
+    return sum;
+}
+
+static double windowedSinc(double position, int numTaps)
+{
+    const double halfLength = numTaps / 2.0;
+    const double windowPosition = position / halfLength;
+    if (std::abs(windowPosition) >= 1.0)
+        return 0.0;
+
+    const double window = besselI0(SINC_KAISER_BETA * std::sqrt(1.0 - windowPosition * windowPosition)) / besselI0(SINC_KAISER_BETA);
+    const double sinc = position == 0.0 ? 1.0 : std::sin(juce::MathConstants<double>::pi * position) / (juce::MathConstants<double>::pi * position);
+    return sinc * window;
+}
+
+// rows are normalised to unity gain at dc, so a constant table interpolates to itself
+template <int NumTaps>
+SincCoefficients<NumTaps>::SincCoefficients()
+{
+    const int firstTap = 1 - NumTaps / 2;
+
+    // one extra row at offset 1 for the last step
+    std::vector<double> rows((size_t) ((SINC_NUM_PHASES + 1) * NumTaps));
+    auto row = [&rows](int phase) { return rows.data() + phase * NumTaps; };
+
+    for (int phase = 0; phase <= SINC_NUM_PHASES; phase++)
+    {
+        const double offset = (double) phase / SINC_NUM_PHASES;
+        double sum = 0.0;
+        for (int tap = 0; tap < NumTaps; tap++)
+        {
+            row(phase)[tap] = windowedSinc((double) (firstTap + tap) - offset, NumTaps);
+            sum += row(phase)[tap];
+        }
+
+        for (int tap = 0; tap < NumTaps; tap++)
+            row(phase)[tap] /= sum;
+    }
+
+    for (int phase = 0; phase < SINC_NUM_PHASES; phase++)
+    {
+        for (int tap = 0; tap < NumTaps; tap++)
+        {
+            values[phase][tap] = (float) row(phase)[tap];
+            steps[phase][tap] = (float) (row(phase + 1)[tap] - row(phase)[tap]);
+        }
+    }
+}
+
+template struct SincCoefficients<8>;
+template struct SincCoefficients<16>;
+template struct SincCoefficients<32>;
+
+void prepareSincCoefficients()
+{
+    SincCoefficients<8>::get();
+    SincCoefficients<16>::get();
+    SincCoefficients<32>::get();
+}
+
+//=============================================================================
+// SCALAR
+
+float renderLinearBlock(const float *values, int tableSize, float phase, float phaseIncrement, float *output, int numSamples)
+{
+    return renderInterpolatedBlock<LinearInterpolation>(values, tableSize, phase, phaseIncrement, output, numSamples);
+}
+
+float renderHermiteBlock(const float *values, int tableSize, float phase, float phaseIncrement, float *output, int numSamples)
+{
+    return renderInterpolatedBlock<HermiteInterpolation>(values, tableSize, phase, phaseIncrement, output, numSamples);
+}
+
+float renderHermite6Block(const float *values, int tableSize, float phase, float phaseIncrement, float *output, int numSamples)
+{
+    return renderInterpolatedBlock<Hermite6Interpolation>(values, tableSize, phase, phaseIncrement, output, numSamples);
+}
+
+float renderSinc8Block(const float *values, int tableSize, float phase, float phaseIncrement, float *output, int numSamples)
+{
+    return renderInterpolatedBlock<SincInterpolation<8>>(values, tableSize, phase, phaseIncrement, output, numSamples);
+}
+
+float renderSinc16Block(const float *values, int tableSize, float phase, float phaseIncrement, float *output, int numSamples)
+{
+    return renderInterpolatedBlock<SincInterpolation<16>>(values, tableSize, phase, phaseIncrement, output, numSamples);
+}
+
+float renderSinc32Block(const float *values, int tableSize, float phase, float phaseIncrement, float *output, int numSamples)
+{
+    return renderInterpolatedBlock<SincInterpolation<32>>(values, tableSize, phase, phaseIncrement, output, numSamples);
+}
+
+//=============================================================================
+// SIMD
+
+// gathers the taps for one register of samples, then finishes any tail with the scalar kernel
+template <typename Interpolation>
+float renderBlockSimd(const float *values, int tableSize, float phase, float phaseIncrement, float *output, int numSamples)
+{
+    constexpr int numLanes = (int) SimdFloat::SIMDNumElements;
+    alignas(32) float taps[Interpolation::numTaps][numLanes];
+    alignas(32) float offsets[numLanes];
+    alignas(32) float results[numLanes];
+
+    int sampleIndex = 0;
+    for (; sampleIndex + numLanes <= numSamples; sampleIndex += numLanes)
+    {
+        for (int lane = 0; lane < numLanes; lane++)
+        {
+            int index;
+            phase = advancePhase(phase, phaseIncrement);
+            splitPhase(phase, tableSize, index, offsets[lane]);
+
+            for (int tap = 0; tap < Interpolation::numTaps; tap++)
+                taps[tap][lane] = values[(index + tap + Interpolation::firstTap + tableSize) % tableSize];
+        }
+
+        Interpolation::interpolate(taps, SimdFloat::fromRawArray(offsets)).copyToRawArray(results);
+
+        for (int lane = 0; lane < numLanes; lane++)
+            output[sampleIndex + lane] = results[lane];
+    }
+
+    return renderInterpolatedBlock<Interpolation>(values, tableSize, phase, phaseIncrement, output + sampleIndex, numSamples - sampleIndex);
+}
+
+float renderLinearBlockSimd(const float *values, int tableSize, float phase, float phaseIncrement, float *output, int numSamples)
+{
+    return renderBlockSimd<LinearInterpolation>(values, tableSize, phase, phaseIncrement, output, numSamples);
+}
+
+float renderHermiteBlockSimd(const float *values, int tableSize, float phase, float phaseIncrement, float *output, int numSamples)
+{
+    return renderBlockSimd<HermiteInterpolation>(values, tableSize, phase, phaseIncrement, output, numSamples);
+}
+
+float renderHermite6BlockSimd(const float *values, int tableSize, float phase, float phaseIncrement, float *output, int numSamples)
+{
+    return renderBlockSimd<Hermite6Interpolation>(values, tableSize, phase, phaseIncrement, output, numSamples);
+}
@@ -0,0 +1,413 @@
+#ifndef INTERPOLATION_H
+#define INTERPOLATION_H
+
+#include <JuceHeader.h>
+
+using SimdFloat = juce::dsp::SIMDRegister<float>;
+
+enum InterpolationModes {
+	InterpolationLinear = 0,
+	InterpolationHermite,
+	InterpolationHermite6,
+	InterpolationSinc8,
+	InterpolationSinc16,
+	InterpolationSinc32,
+	NumInterpolationModes
+};
+
+// renders that need not keep up with realtime use this
+#define OFFLINE_INTERPOLATION_MODE InterpolationSinc32
+
+// windowed sinc coefficients are tabulated at this many offsets between two samples
+#define SINC_NUM_PHASES 256
+#define SINC_KAISER_BETA 8.0
+
+// lower case, as used on the command line and in reports
+const char *getInterpolationModeName(int mode);
+
+// fallback when name is not one of the mode names
+int parseInterpolationMode(const juce::String &name, int fallback);
+
+// builds every windowed sinc table; call off the audio thread before the first sinc render
+void prepareSincCoefficients();
+
+//=============================================================================
+// SINGLE SAMPLE KERNELS, reading a cyclic table around index with a fractional offset
+
+inline float interpolateLinear(const float *values, int tableSize, int index, float offset)
+{
+	const float val1 = values[index % tableSize];
+	const float val2 = values[(index + 1) % tableSize];
+
+	return val1 + offset * (val2 - val1);
+}
+
+// 4-point, 3rd-order hermite
+inline float interpolateHermite(const float *values, int tableSize, int index, float offset)
+{
+	// select 4 samples around index
+	const float val0 = values[(index - 1 + tableSize) % tableSize];
+	const float val1 = values[(index + 0) % tableSize];
+	const float val2 = values[(index + 1) % tableSize];
+	const float val3 = values[(index + 2) % tableSize];
+
+	// calculate slopes to use at points val1 and val2 (avoid discontinuities)
+	const float slope0 = (val2 - val0) * 0.5f;
+	const float slope1 = (val3 - val1) * 0.5f;
+
+	// calculate interpolation coefficients
+	const float delta = val1 - val2;
+	const float slopeSum = slope0 + delta;
+	const float coefficientA = slopeSum + delta + slope1;
+	const float coefficientB = slopeSum + coefficientA;
+
+	// perform interpolation
+	const float stage1 = coefficientA * offset - coefficientB;
+	const float stage2 = stage1 * offset + slope0;
+	return stage2 * offset + val1;
+}
+
+// the same hermite, one independent interpolation per SIMD lane
+inline SimdFloat interpolateHermiteSimd(SimdFloat val0, SimdFloat val1, SimdFloat val2, SimdFloat val3, SimdFloat offset)
+{
+	const auto half = SimdFloat::expand(0.5f);
+
+	const auto slope0 = (val2 - val0) * half;
+	const auto slope1 = (val3 - val1) * half;
+
+	const auto delta = val1 - val2;
+	const auto slopeSum = slope0 + delta;
+	const auto coefficientA = slopeSum + delta + slope1;
+	const auto coefficientB = slopeSum + coefficientA;
+
+	const auto stage1 = coefficientA * offset - coefficientB;
+	const auto stage2 = stage1 * offset + slope0;
+	return stage2 * offset + val1;
+}
+
+// 6-point, 5th-order hermite (olli niemitalo's x-form); continuous in slope and curvature
+inline float interpolateHermite6(const float *values, int tableSize, int index, float offset)
+{
+	const float valM2 = values[(index - 2 + tableSize) % tableSize];
+	const float valM1 = values[(index - 1 + tableSize) % tableSize];
+	const float val0 = values[(index + 0) % tableSize];
+	const float val1 = values[(index + 1) % tableSize];
+	const float val2 = values[(index + 2) % tableSize];
+	const float val3 = values[(index + 3) % tableSize];
+
+	const float c0 = val0;
+	const float c1 = (1.f / 12.f) * (valM2 - val2) + (2.f / 3.f) * (val1 - valM1);
+	const float c2 = (13.f / 12.f) * valM1 - (25.f / 12.f) * val0 + 1.5f * val1 - (11.f / 24.f) * val2 + (1.f / 12.f) * val3 - 0.125f * valM2;
+	const float c3 = (5.f / 12.f) * val0 - (7.f / 12.f) * val1 + (7.f / 24.f) * val2 - (1.f / 24.f) * (valM2 + valM1 + val3);
+	const float c4 = 0.125f * valM2 - (7.f / 12.f) * valM1 + (13.f / 12.f) * val0 - val1 + (11.f / 24.f) * val2 - (1.f / 12.f) * val3;
+	const float c5 = (1.f / 24.f) * (val3 - valM2) + (5.f / 24.f) * (valM1 - val2) + (5.f / 12.f) * (val1 - val0);
+
+	return ((((c5 * offset + c4) * offset + c3) * offset + c2) * offset + c1) * offset + c0;
+}
+
+inline SimdFloat interpolateHermite6Simd(SimdFloat valM2, SimdFloat valM1, SimdFloat val0, SimdFloat val1, SimdFloat val2, SimdFloat val3, SimdFloat offset)
+{
+	auto constant = [](float value) { return SimdFloat::expand(value); };
+
+	const auto c1 = constant(1.f / 12.f) * (valM2 - val2) + constant(2.f / 3.f) * (val1 - valM1);
+	const auto c2 = constant(13.f / 12.f) * valM1 - constant(25.f / 12.f) * val0 + constant(1.5f) * val1
+	              - constant(11.f / 24.f) * val2 + constant(1.f / 12.f) * val3 - constant(0.125f) * valM2;
+	const auto c3 = constant(5.f / 12.f) * val0 - constant(7.f / 12.f) * val1 + constant(7.f / 24.f) * val2
+	              - constant(1.f / 24.f) * (valM2 + valM1 + val3);
+	const auto c4 = constant(0.125f) * valM2 - constant(7.f / 12.f) * valM1 + constant(13.f / 12.f) * val0 - val1
+	              + constant(11.f / 24.f) * val2 - constant(1.f / 12.f) * val3;
+	const auto c5 = constant(1.f / 24.f) * (val3 - valM2) + constant(5.f / 24.f) * (valM1 - val2) + constant(5.f / 12.f) * (val1 - val0);
+
+	return ((((c5 * offset + c4) * offset + c3) * offset + c2) * offset + c1) * offset + val0;
+}
+
+//=============================================================================
+// WINDOWED SINC, NumTaps points around the offset with a kaiser window. each table row holds
+// the taps for one offset and the step to the next row, so offsets in between are linear in
+// the coefficients and the result is two dot products. at offset 0 the taps are a unit
+// impulse, so table samples come back unchanged like the polynomial kernels
+
+template <int NumTaps>
+struct SincCoefficients
+{
+	static_assert(NumTaps % 8 == 0, "rows are dot products over whole SIMD registers");
+
+	SincCoefficients();
+
+	alignas(32) float values[SINC_NUM_PHASES][NumTaps];
+	alignas(32) float steps[SINC_NUM_PHASES][NumTaps];
+
+	static const SincCoefficients &get()
+	{
+		static const SincCoefficients coefficients;
+		return coefficients;
+	}
+};
+
+// taps holds NumTaps samples starting 1 - NumTaps / 2 before the interpolated index
+template <int NumTaps>
+inline float interpolateSinc(const float *taps, float offset)
+{
+	const auto &coefficients = SincCoefficients<NumTaps>::get();
+	const float position = offset * (float) SINC_NUM_PHASES;
+	const int phase = juce::jlimit(0, SINC_NUM_PHASES - 1, (int) position);
+	const float fraction = position - (float) phase;
+
+	auto sum = SimdFloat::expand(0.f);
+	auto slope = SimdFloat::expand(0.f);
+	for (int tap = 0; tap < NumTaps; tap += (int) SimdFloat::SIMDNumElements)
+	{
+		const auto value = SimdFloat::fromRawArray(taps + tap);
+		sum += value * SimdFloat::fromRawArray(coefficients.values[phase] + tap);
+		slope += value * SimdFloat::fromRawArray(coefficients.steps[phase] + tap);
+	}
+
+	return sum.sum() + fraction * slope.sum();
+}
+
+template <int NumTaps>
+inline float interpolateSinc(const float *values, int tableSize, int index, float offset)
+{
+	alignas(32) float taps[NumTaps];
+	const int firstIndex = index + 1 - NumTaps / 2;
+
+	// only the ends of the table wrap
+	if (firstIndex >= 0 && firstIndex + NumTaps <= tableSize)
+	{
+		std::copy(values + firstIndex, values + firstIndex + NumTaps, taps);
+	}
+	else
+	{
+		for (int tap = 0; tap < NumTaps; tap++)
+			taps[tap] = values[(firstIndex + tap + tableSize) % tableSize];
+	}
+
+	return interpolateSinc<NumTaps>(taps, offset);
+}
+
+// one offset per lane: the coefficients are gathered per lane, the dot product runs across lanes
+template <int NumTaps>
+inline SimdFloat interpolateSincSimd(const float (*taps)[SimdFloat::SIMDNumElements], SimdFloat offset)
+{
+	constexpr int numLanes = (int) SimdFloat::SIMDNumElements;
+	const auto &coefficients = SincCoefficients<NumTaps>::get();
+
+	alignas(32) float offsets[numLanes];
+	alignas(32) float laneCoefficients[NumTaps][numLanes];
+	offset.copyToRawArray(offsets);
+
+	for (int lane = 0; lane < numLanes; lane++)
+	{
+		const float position = offsets[lane] * (float) SINC_NUM_PHASES;
+		const int phase = juce::jlimit(0, SINC_NUM_PHASES - 1, (int) position);
+		const float fraction = position - (float) phase;
+
+		for (int tap = 0; tap < NumTaps; tap++)
+			laneCoefficients[tap][lane] = coefficients.values[phase][tap] + fraction * coefficients.steps[phase][tap];
+	}
+
+	auto sum = SimdFloat::expand(0.f);
+	for (int tap = 0; tap < NumTaps; tap++)
+		sum += SimdFloat::fromRawArray(taps[tap]) * SimdFloat::fromRawArray(laneCoefficients[tap]);
+
+	return sum;
+}
+
+//=============================================================================
+// INTERPOLATION POLICIES, for code templated over the interpolation mode. taps are read
+// from index + firstTap onwards; the lane kernel gets one row of taps per tap position
+
+using InterpolationTaps = const float (*)[SimdFloat::SIMDNumElements];
+
+struct LinearInterpolation
+{
+	static constexpr int mode = InterpolationLinear;
+	static constexpr int numTaps = 2;
+	static constexpr int firstTap = 0;
+
+	static float interpolate(const float *values, int tableSize, int index, float offset)
+	{
+		return interpolateLinear(values, tableSize, index, offset);
+	}
+
+	static SimdFloat interpolate(InterpolationTaps taps, SimdFloat offset)
+	{
+		const auto val1 = SimdFloat::fromRawArray(taps[0]);
+		const auto val2 = SimdFloat::fromRawArray(taps[1]);
+		return val1 + offset * (val2 - val1);
+	}
+};
+
+struct HermiteInterpolation
+{
+	static constexpr int mode = InterpolationHermite;
+	static constexpr int numTaps = 4;
+	static constexpr int firstTap = -1;
+
+	static float interpolate(const float *values, int tableSize, int index, float offset)
+	{
+		return interpolateHermite(values, tableSize, index, offset);
+	}
+
+	static SimdFloat interpolate(InterpolationTaps taps, SimdFloat offset)
+	{
+		return interpolateHermiteSimd(SimdFloat::fromRawArray(taps[0]), SimdFloat::fromRawArray(taps[1]),
+		                              SimdFloat::fromRawArray(taps[2]), SimdFloat::fromRawArray(taps[3]), offset);
+	}
+};
+
+struct Hermite6Interpolation
+{
+	static constexpr int mode = InterpolationHermite6;
+	static constexpr int numTaps = 6;
+	static constexpr int firstTap = -2;
+
+	static float interpolate(const float *values, int tableSize, int index, float offset)
+	{
+		return interpolateHermite6(values, tableSize, index, offset);
+	}
+
+	static SimdFloat interpolate(InterpolationTaps taps, SimdFloat offset)
+	{
+		return interpolateHermite6Simd(SimdFloat::fromRawArray(taps[0]), SimdFloat::fromRawArray(taps[1]),
+		                               SimdFloat::fromRawArray(taps[2]), SimdFloat::fromRawArray(taps[3]),
+		                               SimdFloat::fromRawArray(taps[4]), SimdFloat::fromRawArray(taps[5]), offset);
+	}
+};
+
+template <int NumTaps>
+struct SincInterpolation
+{
+	static_assert(NumTaps == 8 || NumTaps == 16 || NumTaps == 32, "no interpolation mode for this length");
+
+	static constexpr int mode = NumTaps == 8 ? InterpolationSinc8 : (NumTaps == 16 ? InterpolationSinc16 : InterpolationSinc32);
+	static constexpr int numTaps = NumTaps;
+	static constexpr int firstTap = 1 - NumTaps / 2;
+
+	static float interpolate(const float *values, int tableSize, int index, float offset)
+	{
+		return interpolateSinc<NumTaps>(values, tableSize, index, offset);
+	}
+
+	static SimdFloat interpolate(InterpolationTaps taps, SimdFloat offset)
+	{
+		return interpolateSincSimd<NumTaps>(taps, offset);
+	}
+};
+
+//=============================================================================
+// PHASE, in [0, 1), advanced before every sample and split into a table index and offset
+
+inline float advancePhase(float phase, float phaseIncrement)
+{
+	phase += phaseIncrement;
+	return phase - std::floor(phase);
+}
+
+inline void splitPhase(float phase, int tableSize, int &index, float &offset)
+{
+	const float scaledPhase = phase * (float) tableSize;
+	index = (int) scaledPhase;
+	offset = scaledPhase - (float) index;
+}
+
+//=============================================================================
+// SHARED LOOPS, the one definition of each loop behind the block kernels below and the
+// instruction set variants in DspKernels. forced inline, so every variant compiles the
+// loop for its own target
+
+template <typename Interpolation>
+forcedinline float renderInterpolatedBlock(const float *values, int tableSize, float phase, float phaseIncrement, float *output, int numSamples)
+{
+	for (int sampleIndex = 0; sampleIndex < numSamples; sampleIndex++)
+	{
+		int index;
+		float offset;
+		phase = advancePhase(phase, phaseIncrement);
+		splitPhase(phase, tableSize, index, offset);
+		output[sampleIndex] = Interpolation::interpolate(values, tableSize, index, offset);
+	}
+
+	return phase;
+}
+
+// unison voices, one per SIMD lane, numVoices padded to whole registers. every voice steps its
+// own phase, and the interpolated voices are summed into mid with gainsMid and, with hasSide,
+// into side with gainsSide; without it side is zeroed. phases, increments and gains are SIMD
+// aligned; the increments are below 1, so one subtraction wraps a phase
+template <typename Interpolation, bool hasSide>
+forcedinline void accumulateUnisonBlock(const float *values, int tableSize, float *phases, const float *phaseIncrements,
+                                        const float *gainsMid, const float *gainsSide, int numVoices,
+                                        float *mid, float *side, int numSamples)
+{
+	constexpr int numLanes = (int) SimdFloat::SIMDNumElements;
+	jassert(numVoices % numLanes == 0);
+
+	const auto one = SimdFloat::expand(1.f);
+	const auto scale = SimdFloat::expand((float) tableSize);
+
+	alignas(32) float scaledPhases[numLanes];
+	alignas(32) float taps[Interpolation::numTaps][numLanes];
+	alignas(32) float offsets[numLanes];
+
+	for (int sample = 0; sample < numSamples; sample++)
+	{
+		auto sumMid = SimdFloat::expand(0.f);
+		auto sumSide = SimdFloat::expand(0.f);
+
+		for (int firstVoice = 0; firstVoice < numVoices; firstVoice += numLanes)
+		{
+			// the same steps as advancePhase, with the wrap as a compare and mask
+			auto phase = SimdFloat::fromRawArray(phases + firstVoice) + SimdFloat::fromRawArray(phaseIncrements + firstVoice);
+			phase = phase - (one & SimdFloat::greaterThanOrEqual(phase, one));
+			phase.copyToRawArray(phases + firstVoice);
+			(phase * scale).copyToRawArray(scaledPhases);
+
+			// SIMDRegister has no float to int conversion, so the split and the table reads stay scalar
+			for (int lane = 0; lane < numLanes; lane++)
+			{
+				const int index = (int) scaledPhases[lane];
+				offsets[lane] = scaledPhases[lane] - (float) index;
+
+				for (int tap = 0; tap < Interpolation::numTaps; tap++)
+					taps[tap][lane] = values[(index + tap + Interpolation::firstTap + tableSize) % tableSize];
+			}
+
+			const auto value = Interpolation::interpolate(taps, SimdFloat::fromRawArray(offsets));
+
+			sumMid += value * SimdFloat::fromRawArray(gainsMid + firstVoice);
+			if (hasSide)
+				sumSide += value * SimdFloat::fromRawArray(gainsSide + firstVoice);
+		}
+
+		mid[sample] = sumMid.sum();
+		side[sample] = hasSide ? sumSide.sum() : 0.f;
+	}
+}
+
+//=============================================================================
+// BLOCK KERNELS, advancing a phase in [0, 1) by phaseIncrement before every sample
+// the same way the oscillator does; each returns the phase after the last sample
+
+using InterpolationBlockKernel = float (*)(const float *values, int tableSize, float phase, float phaseIncrement, float *output, int numSamples);
+
+// accumulateUnisonBlock for one interpolation mode and side layout
+using UnisonBlockKernel = void (*)(const float *values, int tableSize, float *phases, const float *phaseIncrements,
+                                   const float *gainsMid, const float *gainsSide, int numVoices,
+                                   float *mid, float *side, int numSamples);
+
+float renderLinearBlock(const float *values, int tableSize, float phase, float phaseIncrement, float *output, int numSamples);
+float renderHermiteBlock(const float *values, int tableSize, float phase, float phaseIncrement, float *output, int numSamples);
+float renderHermite6Block(const float *values, int tableSize, float phase, float phaseIncrement, float *output, int numSamples);
+
+// taps gathered per sample, the dot products run across SIMD lanes
+float renderSinc8Block(const float *values, int tableSize, float phase, float phaseIncrement, float *output, int numSamples);
+float renderSinc16Block(const float *values, int tableSize, float phase, float phaseIncrement, float *output, int numSamples);
+float renderSinc32Block(const float *values, int tableSize, float phase, float phaseIncrement, float *output, int numSamples);
+
+// table reads stay scalar, the interpolation runs across SIMD lanes
+float renderLinearBlockSimd(const float *values, int tableSize, float phase, float phaseIncrement, float *output, int numSamples);
+float renderHermiteBlockSimd(const float *values, int tableSize, float phase, float phaseIncrement, float *output, int numSamples);
+float renderHermite6BlockSimd(const float *values, int tableSize, float phase, float phaseIncrement, float *output, int numSamples);
+
+#endif // INTERPOLATION_H
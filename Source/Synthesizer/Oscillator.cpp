@@ -17,7 +17,10 @@ inline float clampFloat (float input, float lowerBound, float upperBound)
 
 Oscillator::Oscillator()
 {
-    adsrScalars.setSize(1, 8096, false, false, false);
+    kernels = &getDspKernels();
+    envelopeLevel = 0.f;
+    appliedLevel = 0.f;
+    envelopeIsReleasing = false;
     
     octaveTranspose = 0;
     semitoneTranspose = 0;
@@ -29,7 +32,13 @@ Oscillator::Oscillator()
     wavetableNumFrames = 0;
     wavetableFrameIndex = 0;
 
-    randomizePhases();
+    for (int detuneVoice = 0; detuneVoice < maxPaddedDetuneVoices; detuneVoice++)
+    {
+        phases[detuneVoice] = 0.f;
+        unisonPhaseIncrements[detuneVoice] = 0.f;
+        unisonGainsMid[detuneVoice] = 0.f;
+        unisonGainsSide[detuneVoice] = 0.f;
+    }
     deltaPhase = 0.f;
     sampleIndex = 0;
     sampleOffset = 0.f;
@@ -49,18 +58,16 @@ Oscillator::Oscillator()
     detuneVoices = 1;
     detuneMix = 1.f;
     detuneSpread = 1.f;
-    for (auto& detuneFrequencyCoefficient : detuneFrequencyCoefficients)
-    {
-        detuneFrequencyCoefficient = 1.f;
-    }
-    for (auto& detuneVolumeCoefficient : detuneVolumeCoefficients)
-    {
-        detuneVolumeCoefficient = 1.f;
-    }
-    for (auto& detunePanningOffset : detunePanningOffsets)
-    {
-        detunePanningOffset = 0.f;
-    }
+
+    detuneFrequencyCoefficients.reserve(MAX_DETUNE_VOICES);
+    detuneVolumeCoefficients.reserve(MAX_DETUNE_VOICES);
+    detunePanningOffsets.reserve(MAX_DETUNE_VOICES);
+    detuneFrequencyUnits.reserve(MAX_DETUNE_VOICES);
+    detunePanningUnits.reserve(MAX_DETUNE_VOICES);
+    resizeDetuneVoices();
+
+    interpolationMode = InterpolationHermite;
+    prepare(8096);
 }
 
 Oscillator::Oscillator(const Wavetable *wavetableToUse) : Oscillator::Oscillator()
@@ -73,69 +80,333 @@ Oscillator::~Oscillator() {}
 //=============================================================================
 // RENDER
 
-void Oscillator::render(juce::AudioBuffer<float> &outputBuffer, int startSample, int numSamples)
+// size the per-block scratch buffers; must be called off the audio thread
+void Oscillator::prepare(int maximumBlockSize, int numChannels)
 {
-    auto output = outputBuffer.getArrayOfWritePointers();
+    jassert(numChannels == 1 || numChannels == 2);
+
+    adsrScalars.setSize(1, maximumBlockSize, false, false, false);
+    rampScalars.setSize(NumRampScalarChannels, maximumBlockSize, false, false, false);
+
+    numOutputChannels = juce::jlimit(1, 2, numChannels);
+    updateRenderKernel();
+}
+
+void Oscillator::render(juce::AudioBuffer<float> &outputBuffer, int startSample, int numSamples, const ParameterRamps &ramps)
+{
+    jassert(numSamples <= adsrScalars.getNumSamples());
+    jassert(outputBuffer.getNumChannels() == numOutputChannels);
+
+    // a midi event on the first sample of a segment leaves nothing to render before it;
+    // the kernels read their last sample and divide by the length
+    if (numSamples <= 0)
+        return;
+
+    // store the next N samples of the adsr envelope, scaled by velocity and volume
+    auto *gains = adsrScalars.getWritePointer(0);
+    adsrEnvelope.render(gains, numSamples, *kernels);
+
+    envelopeLevel = gains[numSamples - 1];
+
+    kernels->applyGain(gains, ramps.volume, ramps.volume != nullptr ? velocity : baseVolume * velocity, numSamples);
+    appliedLevel = gains[numSamples - 1];
+
+    (this->*renderKernel)(outputBuffer.getArrayOfWritePointers(), startSample, numSamples, ramps);
+}
+
+//=============================================================================
+// RENDER KERNELS
+
+// [mono][unison] instances for one interpolation mode
+#define OSCILLATOR_RENDER_KERNELS(Interpolation) \
+    { { &Oscillator::renderBlock<Interpolation, false, false>, &Oscillator::renderBlock<Interpolation, false, true> }, \
+      { &Oscillator::renderBlock<Interpolation, true, false>,  &Oscillator::renderBlock<Interpolation, true, true> } }
+
+// [interpolation mode][mono][unison]
+const Oscillator::RenderKernel Oscillator::renderKernels[NumInterpolationModes][2][2] = {
+    OSCILLATOR_RENDER_KERNELS(LinearInterpolation),
+    OSCILLATOR_RENDER_KERNELS(HermiteInterpolation),
+    OSCILLATOR_RENDER_KERNELS(Hermite6Interpolation),
+    OSCILLATOR_RENDER_KERNELS(SincInterpolation<8>),
+    OSCILLATOR_RENDER_KERNELS(SincInterpolation<16>),
+    OSCILLATOR_RENDER_KERNELS(SincInterpolation<32>)
+};
+
+#undef OSCILLATOR_RENDER_KERNELS
+
+// called whenever the mode, the output layout or the number of detune voices changes
+void Oscillator::updateRenderKernel()
+{
+    renderKernel = renderKernels[interpolationMode][numOutputChannels == 1 ? 1 : 0][detuneVoices > 1 ? 1 : 0];
+}
+
+// one voice, or a unison whose voices are summed across SIMD lanes unless the spread moves
+template <typename Interpolation, bool isMono, bool isUnison>
+void Oscillator::renderBlock(float *const *output, int startSample, int numSamples, const ParameterRamps &ramps)
+{
+    // the base pan angle only needs per-sample trig while the pan is moving
+    const bool panIsRamping = !isMono && ramps.pan != nullptr;
+    if (panIsRamping)
+    {
+        auto *cosTheta = rampScalars.getWritePointer(BasePanCosChannel);
+        auto *sinTheta = rampScalars.getWritePointer(BasePanSinChannel);
+        for (int sampleIndex = 0; sampleIndex < numSamples; sampleIndex++)
+        {
+            const float angle = (juce::MathConstants<float>::pi / 4.0f) * (1.0f + ramps.pan[sampleIndex]);
+            cosTheta[sampleIndex] = std::cos(angle);
+            sinTheta[sampleIndex] = std::sin(angle);
+        }
+    }
+
+    const bool spreadIsRamping = isUnison && ramps.detuneSpread != nullptr && isDetuneActive();
 
-    // store the next N samples of the adsr envelope
-    adsrScalars.clear();
-    for (int adsrScalarIndex = 0; adsrScalarIndex < numSamples; adsrScalarIndex++)
+    // a moving base pan only rotates the mid/side sum, so only a moving spread needs every
+    // voice rendered on its own
+    if (isUnison && !spreadIsRamping)
     {
-        adsrScalars.setSample(0, adsrScalarIndex, adsrEnvelope.getNextSample());
+        renderUnison<Interpolation, isMono>(output, startSample, numSamples, ramps);
+        return;
     }
 
     // for each detune voice, add a wave to the output buffer
-    for (int detuneVoice = 0; detuneVoice < detuneVoices; detuneVoice++)
+    const int numVoices = isUnison ? detuneVoices : 1;
+    for (int detuneVoice = 0; detuneVoice < numVoices; detuneVoice++)
     {
         applyRenderParameters(detuneVoice);
         updateDeltaPhase();
-        int adsrScalarIndex = 0;
 
-        // render the damn wave!
-        for (int outputSampleIndex = startSample; outputSampleIndex < (startSample + numSamples); outputSampleIndex++)
+        if (panIsRamping || spreadIsRamping)
+            renderVoiceWithRamps<Interpolation, isMono>(output, detuneVoice, startSample, numSamples, ramps);
+        else
+            renderVoice<Interpolation, isMono>(output, detuneVoice, startSample, numSamples);
+    }
+}
+
+//=============================================================================
+// RENDER
+
+// constant parameters: pan and phase increment are fixed for the whole block
+template <typename Interpolation, bool isMono>
+void Oscillator::renderVoice(float *const *output, int detuneVoice, int startSample, int numSamples)
+{
+    const auto *gains = adsrScalars.getReadPointer(0);
+
+    // render the damn wave! the phase increment channel is free while nothing ramps
+    auto *samples = rampScalars.getWritePointer(PhaseIncrementChannel);
+    phases[detuneVoice] = kernels->renderBlock[Interpolation::mode](wavetable->getReadPointer(wavetableFrameIndex), wavetableSize,
+                                                                    phases[detuneVoice], deltaPhase, samples, numSamples);
+
+    if (isMono)
+    {
+        kernels->mixMono(output[0] + startSample, samples, gains, renderVolume * MONO_OUTPUT_GAIN, numSamples);
+        return;
+    }
+
+    kernels->mixStereo(output[0] + startSample, output[1] + startSample, samples, gains,
+                       renderVolume * renderPanCoefficientLeft, renderVolume * renderPanCoefficientRight, numSamples);
+}
+
+// several detune voices, spread constant. pan(theta + delta) expands to a mid term scaled by
+// cos(delta) and a side term scaled by sin(delta), so every voice is summed into one mid and one
+// side buffer in SIMD lanes and the base pan is applied once per sample when writing the output.
+// centred voices have no side term, and without any side term the sum stays mono. a mono
+// output is the mid sum alone
+template <typename Interpolation, bool isMono>
+void Oscillator::renderUnison(float *const *output, int startSample, int numSamples, const ParameterRamps &ramps)
+{
+    const bool hasSide = prepareUnisonLanes() && !isMono;
+    const int numPaddedVoices = (detuneVoices + numUnisonLanes - 1) / numUnisonLanes * numUnisonLanes;
+    const auto accumulateUnison = kernels->accumulateUnison[Interpolation::mode][hasSide ? 1 : 0];
+    const auto *values = wavetable->getReadPointer(wavetableFrameIndex);
+    const auto *gains = adsrScalars.getReadPointer(0);
+
+    const float theta = (juce::MathConstants<float>::pi / 4.0f) * (1.0f + basePan);
+    const float constantCosTheta = std::cos(theta);
+    const float constantSinTheta = std::sin(theta);
+    const auto *cosTheta = ramps.pan != nullptr && !isMono ? rampScalars.getReadPointer(BasePanCosChannel) : nullptr;
+    const auto *sinTheta = ramps.pan != nullptr && !isMono ? rampScalars.getReadPointer(BasePanSinChannel) : nullptr;
+
+    alignas(16) float mid[UNISON_ACCUMULATOR_SIZE];
+    alignas(16) float side[UNISON_ACCUMULATOR_SIZE];
+
+    for (int chunkStart = 0; chunkStart < numSamples; chunkStart += UNISON_ACCUMULATOR_SIZE)
+    {
+        const int chunkLength = juce::jmin(UNISON_ACCUMULATOR_SIZE, numSamples - chunkStart);
+        accumulateUnison(values, wavetableSize, phases, unisonPhaseIncrements, unisonGainsMid, unisonGainsSide, numPaddedVoices,
+                         mid, side, chunkLength);
+
+        const auto *chunkGains = gains + chunkStart;
+        auto *left = output[0] + startSample + chunkStart;
+
+        if (isMono)
         {
-            incrementPhase(detuneVoice);
-            auto sampleValue = getNextSample() * renderVolume * velocity;
-            auto adsrScalarValue = adsrScalars.getSample(0, ++adsrScalarIndex);
-            output[0][outputSampleIndex] += sampleValue * renderPanCoefficientLeft * adsrScalarValue;
-            output[1][outputSampleIndex] += sampleValue * renderPanCoefficientRight * adsrScalarValue;
+            kernels->mixMono(left, mid, chunkGains, MONO_OUTPUT_GAIN, chunkLength);
+            continue;
         }
+
+        auto *right = output[1] + startSample + chunkStart;
+
+        if (cosTheta != nullptr)
+            kernels->mixMidSide(left, right, mid, side, chunkGains, cosTheta + chunkStart, sinTheta + chunkStart, chunkLength);
+        else
+            kernels->mixMidSideConstant(left, right, mid, side, chunkGains, constantCosTheta, constantSinTheta, chunkLength);
     }
 }
 
-float Oscillator::getNextSample()
+// fills the lane arrays from the current detune configuration; returns whether any voice
+// sits off centre
+bool Oscillator::prepareUnisonLanes()
 {
-    // select 4 samples around sampleIndex
-    auto values = wavetable->getReadPointer(wavetableFrameIndex);
-    const float val0 = values[(sampleIndex - 1 + wavetableSize) % wavetableSize];
-    const float val1 = values[(sampleIndex + 0) % wavetableSize];
-    const float val2 = values[(sampleIndex + 1) % wavetableSize];
-    const float val3 = values[(sampleIndex + 2) % wavetableSize];
+    const float quarterPi = juce::MathConstants<float>::pi / 4.0f;
+    const int numPaddedVoices = (detuneVoices + numUnisonLanes - 1) / numUnisonLanes * numUnisonLanes;
+    bool hasSide = false;
+
+    for (int detuneVoice = 0; detuneVoice < detuneVoices; detuneVoice++)
+    {
+        applyRenderParameters(detuneVoice);
+        updateDeltaPhase();
+
+        const float delta = isDetuneActive() ? quarterPi * detunePanningOffsets[detuneVoice] : 0.f;
+        // whole cycles are dropped, so the lanes wrap with a single subtraction
+        unisonPhaseIncrements[detuneVoice] = deltaPhase - std::floor(deltaPhase);
+        unisonGainsMid[detuneVoice] = renderVolume * std::cos(delta);
+        unisonGainsSide[detuneVoice] = renderVolume * std::sin(delta);
+
+        hasSide = hasSide || unisonGainsSide[detuneVoice] != 0.f;
+    }
+
+    // padding lanes stand still and are silent
+    for (int detuneVoice = detuneVoices; detuneVoice < numPaddedVoices; detuneVoice++)
+    {
+        unisonPhaseIncrements[detuneVoice] = 0.f;
+        unisonGainsMid[detuneVoice] = 0.f;
+        unisonGainsSide[detuneVoice] = 0.f;
+    }
+
+    return hasSide;
+}
+
+// moving parameters: per-sample phase increments and pan gains are rendered first
+template <typename Interpolation, bool isMono>
+void Oscillator::renderVoiceWithRamps(float *const *output, int detuneVoice, int startSample, int numSamples, const ParameterRamps &ramps)
+{
+    const auto *gains = adsrScalars.getReadPointer(0);
+    auto *phaseIncrements = rampScalars.getWritePointer(PhaseIncrementChannel);
+    auto *panLeft = rampScalars.getWritePointer(PanLeftChannel);
+    auto *panRight = rampScalars.getWritePointer(PanRightChannel);
+
+    const bool voiceIsDetuned = isDetuneActive();
+    const bool spreadIsRamping = voiceIsDetuned && ramps.detuneSpread != nullptr;
+
+    //------------------------------------------------------------------------
+    // PHASE INCREMENTS
+
+    // detuned frequency is linear in spread, so the ramp can be followed exactly
+    if (spreadIsRamping)
+    {
+        const float frequencyUnit = detuneFrequencyUnits[detuneVoice];
+        const float centreDeltaPhase = deltaPhase / (1.f + frequencyUnit * detuneSpread);
+        for (int sampleIndex = 0; sampleIndex < numSamples; sampleIndex++)
+        {
+            phaseIncrements[sampleIndex] = centreDeltaPhase * (1.f + frequencyUnit * ramps.detuneSpread[sampleIndex]);
+        }
+    }
+    else
+    {
+        juce::FloatVectorOperations::fill(phaseIncrements, deltaPhase, numSamples);
+    }
+
+    //------------------------------------------------------------------------
+    // PAN GAINS
+
+    // pan angle = base angle theta + detune offset delta, expanded so only theta needs
+    // per-sample trig; delta is interpolated linearly across the block while spread moves
+    const float quarterPi = juce::MathConstants<float>::pi / 4.0f;
+    const float panningUnit = voiceIsDetuned ? detunePanningUnits[detuneVoice] : 0.f;
+    const float deltaStart = quarterPi * panningUnit * (spreadIsRamping ? ramps.detuneSpread[0] : detuneSpread);
+    const float deltaEnd = quarterPi * panningUnit * (spreadIsRamping ? ramps.detuneSpread[numSamples - 1] : detuneSpread);
 
-    // calculate slopes to use at points val1 and val2 (avoid discontinuities)
-    const float slope0 = (val2 - val0) * 0.5f;
-    const float slope1 = (val3 - val1) * 0.5f;
+    const float cosDeltaStart = std::cos(deltaStart);
+    const float sinDeltaStart = std::sin(deltaStart);
+    const float cosDeltaStep = (std::cos(deltaEnd) - cosDeltaStart) / (float) numSamples;
+    const float sinDeltaStep = (std::sin(deltaEnd) - sinDeltaStart) / (float) numSamples;
 
-    // calculate interpolation coefficients
-    const float delta = val1 - val2;
-    const float slopeSum = slope0 + delta;
-    const float coefficientA = slopeSum + delta + slope1;
-    const float coefficientB = slopeSum + coefficientA;
+    if (isMono)
+    {
+        // only the centred part of the voice reaches a mono output
+        for (int sampleIndex = 0; sampleIndex < numSamples; sampleIndex++)
+        {
+            panLeft[sampleIndex] = renderVolume * MONO_OUTPUT_GAIN * (cosDeltaStart + cosDeltaStep * (float) sampleIndex);
+        }
+    }
+    else if (ramps.pan != nullptr)
+    {
+        const auto *cosTheta = rampScalars.getReadPointer(BasePanCosChannel);
+        const auto *sinTheta = rampScalars.getReadPointer(BasePanSinChannel);
+        for (int sampleIndex = 0; sampleIndex < numSamples; sampleIndex++)
+        {
+            const float cosDelta = cosDeltaStart + cosDeltaStep * (float) sampleIndex;
+            const float sinDelta = sinDeltaStart + sinDeltaStep * (float) sampleIndex;
+            panLeft[sampleIndex] = renderVolume * (cosTheta[sampleIndex] * cosDelta - sinTheta[sampleIndex] * sinDelta);
+            panRight[sampleIndex] = renderVolume * (sinTheta[sampleIndex] * cosDelta + cosTheta[sampleIndex] * sinDelta);
+        }
+    }
+    else
+    {
+        const float theta = quarterPi * (1.0f + basePan);
+        const float cosTheta = std::cos(theta);
+        const float sinTheta = std::sin(theta);
+        for (int sampleIndex = 0; sampleIndex < numSamples; sampleIndex++)
+        {
+            const float cosDelta = cosDeltaStart + cosDeltaStep * (float) sampleIndex;
+            const float sinDelta = sinDeltaStart + sinDeltaStep * (float) sampleIndex;
+            panLeft[sampleIndex] = renderVolume * (cosTheta * cosDelta - sinTheta * sinDelta);
+            panRight[sampleIndex] = renderVolume * (sinTheta * cosDelta + cosTheta * sinDelta);
+        }
+    }
+
+    //------------------------------------------------------------------------
+    // RENDER
+
+    if (isMono)
+    {
+        for (int sampleIndex = 0; sampleIndex < numSamples; sampleIndex++)
+        {
+            incrementPhase(detuneVoice, phaseIncrements[sampleIndex]);
+            output[0][startSample + sampleIndex] += getNextSample<Interpolation>() * gains[sampleIndex] * panLeft[sampleIndex];
+        }
+        return;
+    }
 
-    // perform interpolation
-    const float stage1 = coefficientA * sampleOffset - coefficientB;
-    const float stage2 = stage1 * sampleOffset + slope0;
-    const float result = stage2 * sampleOffset + val1;
+    for (int sampleIndex = 0; sampleIndex < numSamples; sampleIndex++)
+    {
+        incrementPhase(detuneVoice, phaseIncrements[sampleIndex]);
+        auto sampleValue = getNextSample<Interpolation>() * gains[sampleIndex];
+        output[0][startSample + sampleIndex] += sampleValue * panLeft[sampleIndex];
+        output[1][startSample + sampleIndex] += sampleValue * panRight[sampleIndex];
+    }
+}
 
-    return result;
+template <typename Interpolation>
+float Oscillator::getNextSample()
+{
+    auto values = wavetable->getReadPointer(wavetableFrameIndex);
+    return Interpolation::interpolate(values, wavetableSize, sampleIndex, sampleOffset);
 }
 
 //=============================================================================
 // APPLY RENDER PARAMETERS
 
+bool Oscillator::isDetuneActive() const
+{
+    return detuneVoices > 1 && detuneMix > 0.f;
+}
+
+// volume and velocity are applied through adsrScalars, so renderVolume only
+// carries the relative level of the detune voice
 void Oscillator::applyRenderParameters(int detuneVoice)
 {
-    if (detuneVoices > 1 && detuneMix > 0.f)
+    if (isDetuneActive())
         applyDetuneRenderParameters(detuneVoice);
     else
         applyBaseRenderParameters();
@@ -148,7 +419,7 @@ void Oscillator::applyDetuneRenderParameters(int detuneVoice)
     
     renderFrequency = baseFrequency * detuneFrequencyCoefficients[detuneVoice] * transposeCoefficient;
 
-    renderVolume = baseVolume * detuneVolumeCoefficients[detuneVoice];
+    renderVolume = detuneVolumeCoefficients[detuneVoice];
     calculateRenderPanCoefficients(basePan + detunePanningOffsets[detuneVoice]);
 }
 
@@ -159,7 +430,7 @@ void Oscillator::applyBaseRenderParameters()
     
     renderFrequency = baseFrequency * transposeCoefficient;
  
-    renderVolume = baseVolume;
+    renderVolume = 1.f;
     calculateRenderPanCoefficients(basePan);
 }
 
@@ -184,9 +455,9 @@ void Oscillator::setTransposeValues(int octave, int semitone, int fine, float co
 // PHASE UPDATE
 
 // update the phase and calculate sampleIndex and sampleOffset
-void Oscillator::incrementPhase(int phaseIndex)
+void Oscillator::incrementPhase(int phaseIndex, float phaseIncrement)
 {
-    phases[phaseIndex] += deltaPhase;
+    phases[phaseIndex] += phaseIncrement;
     phases[phaseIndex] -= std::floor(phases[phaseIndex]);
 
     float scaledPhase = phases[phaseIndex] * wavetableSize;
@@ -204,12 +475,13 @@ void Oscillator::updateDeltaPhase()
         deltaPhase = juce::jmax(0.f, renderFrequency / sampleRate);
 }
 
-void Oscillator::randomizePhases()
+// draws every unison phase from the caller's generator, so a seeded generator
+// gives the same phases for the same sequence of notes
+void Oscillator::randomizePhases(juce::Random &random)
 {
-    juce::Random rng;
-    for (auto &phase : phases)
+    for (int detuneVoice = 0; detuneVoice < MAX_DETUNE_VOICES; detuneVoice++)
     {
-        phase = rng.nextFloat();
+        phases[detuneVoice] = random.nextFloat();
     }
 }
 
@@ -224,19 +496,22 @@ void Oscillator::calculateDetuneFrequencyCoefficients()
     // if odd number of voices, assign baseFrequency to center voice
     if (detuneVoices % 2 != 0)
     {
+        detuneFrequencyUnits[numVoicesAssigned] = 0.f;
         detuneFrequencyCoefficients[numVoicesAssigned++] = 1.f;
     }
 
     // assign frequency coefficients to remaining voices
-    const float maxFrequencyCoefficient = MAX_DETUNE_SPREAD * 0.2f * detuneSpread;
-    float frequencyStep = maxFrequencyCoefficient / (float) std::floor(detuneVoices / 2);
+    const float maxFrequencyUnit = MAX_DETUNE_SPREAD * 0.2f;
+    float frequencyStep = maxFrequencyUnit / (float) std::floor(detuneVoices / 2);
 
     int numVoicePairsToCreate = (detuneVoices - numVoicesAssigned) / 2;
     for (int voicePair = 1; voicePair <= numVoicePairsToCreate; voicePair++)
     {
-        float frequencyCoefficient = frequencyStep * voicePair;
-        detuneFrequencyCoefficients[numVoicesAssigned++] = 1 - frequencyCoefficient;
-        detuneFrequencyCoefficients[numVoicesAssigned++] = 1 + frequencyCoefficient;
+        float frequencyUnit = frequencyStep * voicePair;
+        detuneFrequencyUnits[numVoicesAssigned] = 0 - frequencyUnit;
+        detuneFrequencyCoefficients[numVoicesAssigned++] = 1 - frequencyUnit * detuneSpread;
+        detuneFrequencyUnits[numVoicesAssigned] = 0 + frequencyUnit;
+        detuneFrequencyCoefficients[numVoicesAssigned++] = 1 + frequencyUnit * detuneSpread;
     }
 }
 
@@ -268,28 +543,43 @@ void Oscillator::calculateDetunePanningOffsets()
 {
     int numVoicesAssigned = 0;
 
-    // if odd number of voices, assign basePan to center voice
+    // if odd number of voices, the center voice sits at basePan
     if (detuneVoices % 2 != 0)
     {
-        detunePanningOffsets[numVoicesAssigned++] = basePan;
+        detunePanningUnits[numVoicesAssigned] = 0.f;
+        detunePanningOffsets[numVoicesAssigned++] = 0.f;
     }
 
     // offsets are symmetric from -maxPanningOffset to +maxPanningOffset
-    const float maxPanningOffset = 0.5f * detuneSpread;
+    const float maxPanningUnit = 0.5f;
 
     // panning step is the panning offset for the next further out pair of voices
-    float panningStep = maxPanningOffset / (float) std::floor(detuneVoices / 2.0);
+    float panningStep = maxPanningUnit / (float) std::floor(detuneVoices / 2.0);
 
     // create voices
     int numVoicePairsToCreate = (detuneVoices - numVoicesAssigned) / 2;
     for (int voicePair = 1; voicePair <= numVoicePairsToCreate; ++voicePair)
     {
-        float panOffset = panningStep * voicePair;
-        detunePanningOffsets[numVoicesAssigned++] = 0 - panOffset;
-        detunePanningOffsets[numVoicesAssigned++] = 0 + panOffset;
+        float panUnit = panningStep * voicePair;
+        detunePanningUnits[numVoicesAssigned] = 0 - panUnit;
+        detunePanningOffsets[numVoicesAssigned++] = (0 - panUnit) * detuneSpread;
+        detunePanningUnits[numVoicesAssigned] = 0 + panUnit;
+        detunePanningOffsets[numVoicesAssigned++] = (0 + panUnit) * detuneSpread;
     }
 }
 
+// one coefficient per detune voice; stays within the reserved capacity, so this is safe on
+// the audio thread. new voices start centred until the configuration is recalculated
+void Oscillator::resizeDetuneVoices()
+{
+    const auto numVoices = (size_t) detuneVoices;
+    detuneFrequencyCoefficients.resize(numVoices, 1.f);
+    detuneVolumeCoefficients.resize(numVoices, 1.f);
+    detunePanningOffsets.resize(numVoices, 0.f);
+    detuneFrequencyUnits.resize(numVoices, 0.f);
+    detunePanningUnits.resize(numVoices, 0.f);
+}
+
 // recalculate all dependent values
 void Oscillator::updateDetuneVoiceConfiguration()
 {
@@ -310,6 +600,8 @@ int Oscillator::getDetuneVoices() const
 void Oscillator::setDetuneVoices(int newNumVoices)
 {
     this->detuneVoices = clampInt(newNumVoices, 1, MAX_DETUNE_VOICES);
+    resizeDetuneVoices();
+    updateRenderKernel();
 };
 
 // detune mix
@@ -337,10 +629,10 @@ void Oscillator::setDetuneSpread(float newDetuneSpread)
 //=============================================================================
 // RENDER PARAMETERS
 
-// sample rate [1, 192000]
+// sample rate [1, MAX_OSCILLATOR_SAMPLE_RATE]
 void Oscillator::setSampleRate(float newSampleRate)
 {
-    newSampleRate = clampFloat(newSampleRate, 1.f, 192000.f);
+    newSampleRate = clampFloat(newSampleRate, 1.f, MAX_OSCILLATOR_SAMPLE_RATE);
     this->sampleRate = newSampleRate;
     this->adsrEnvelope.setSampleRate(newSampleRate);
 }
@@ -385,6 +677,18 @@ void Oscillator::setWavetableFrameIndex(int newFrameIndex)
     this->wavetableFrameIndex = clampInt(newFrameIndex, 0, wavetableNumFrames);
 }
 
+// [0, NumInterpolationModes)
+void Oscillator::setInterpolationMode(int newInterpolationMode)
+{
+    this->interpolationMode = clampInt(newInterpolationMode, 0, NumInterpolationModes - 1);
+    updateRenderKernel();
+}
+
+int Oscillator::getInterpolationMode() const
+{
+    return interpolationMode;
+}
+
 //=============================================================================
 // ADSR
 
@@ -396,14 +700,53 @@ void Oscillator::setAdsrParameters(juce::ADSR::Parameters adsrParameters)
 void Oscillator::startAdsrEnvelope()
 {
     adsrEnvelope.noteOn();
+    envelopeIsReleasing = false;
+
+    // nothing of this note is rendered yet, so a release before its first block is not culled
+    appliedLevel = 1.f;
 }
 
 void Oscillator::releaseAdsrEnvelope()
 {
     adsrEnvelope.noteOff();
+    envelopeIsReleasing = true;
+}
+
+// ends the note at once, without finishing the release
+void Oscillator::stopAdsrEnvelope()
+{
+    adsrEnvelope.reset();
+    envelopeLevel = 0.f;
+    appliedLevel = 0.f;
+    envelopeIsReleasing = false;
 }
 
 bool Oscillator::adsrEnvelopeIsActive() const
 {
     return adsrEnvelope.isActive();
+}
+
+// envelope value at the end of the last rendered block
+float Oscillator::getEnvelopeLevel() const
+{
+    return adsrEnvelope.isActive() ? envelopeLevel : 0.f;
+}
+
+// only a released note is tested: an attack also starts from silence. the level is the gain
+// the last block ended on, with the volume as it was ramped, times the sum of every detune
+// voice's level, so neither a volume ramp nor a wide unison retires the note early
+bool Oscillator::isReleasedBelow(float gain) const
+{
+    if (!envelopeIsReleasing || !adsrEnvelope.isActive())
+        return false;
+
+    float unisonLevel = (float) detuneVoices;
+    if (isDetuneActive())
+    {
+        unisonLevel = 0.f;
+        for (auto detuneVolumeCoefficient : detuneVolumeCoefficients)
+            unisonLevel += detuneVolumeCoefficient;
+    }
+
+    return appliedLevel * unisonLevel < gain;
 }
\ No newline at end of file
@@ -2,12 +2,32 @@
 #define OSCILLATOR_H
 
 #include <JuceHeader.h>
+#include "Interpolation.h"
+#include "DspKernels.h"
+#include "AdsrEnvelope.h"
 
-#define MAX_DETUNE_VOICES 12
+#define MAX_DETUNE_VOICES 64
 #define MAX_DETUNE_SPREAD 0.05f
 
+// unison voices are summed into stack buffers of this many samples before touching the output
+#define UNISON_ACCUMULATOR_SIZE 64
+
+// a mono output carries what a centred voice puts on each stereo channel
+#define MONO_OUTPUT_GAIN 0.70710678f
+
+// a 192 kHz output at the highest oversampling factor
+#define MAX_OSCILLATOR_SAMPLE_RATE 3072000.f
+
 using Wavetable = juce::AudioBuffer<float>;
 
+// per-sample parameter values for one render call, nullptr when the parameter is constant
+struct ParameterRamps
+{
+	const float *volume = nullptr;
+	const float *pan = nullptr;
+	const float *detuneSpread = nullptr;
+};
+
 class Oscillator
 {
 
@@ -19,7 +39,11 @@ public:
 	~Oscillator();
 
 	//=============================================================================
-	void render(juce::AudioBuffer<float> &outputBuffer, int startSample, int numSamples);
+	// numOutputChannels is 1 or 2; render must then be handed that many channels
+	void prepare(int maximumBlockSize, int numOutputChannels = 2);
+
+	// a mono output skips panning entirely
+	void render(juce::AudioBuffer<float> &outputBuffer, int startSample, int numSamples, const ParameterRamps &ramps = {});
 
 	void setSampleRate(float);
 	void setFrequency(float);
@@ -28,7 +52,7 @@ public:
 	void setPan(float);
 
 	//=============================================================================
-	void randomizePhases();
+	void randomizePhases(juce::Random &);
 	
 	void setDetuneVoices(int);
 	void setDetuneMix(float);
@@ -43,17 +67,41 @@ public:
 	void setWavetable(const Wavetable *);
 	void setWavetableFrameIndex(int);
 
+	// one of InterpolationModes
+	void setInterpolationMode(int);
+	int getInterpolationMode() const;
+
 	//=============================================================================
 	void setTransposeValues(int, int, int, float);
 	void setAdsrParameters(juce::ADSR::Parameters adsrParameters);
 	void startAdsrEnvelope();
 	void releaseAdsrEnvelope();
+	void stopAdsrEnvelope();
 	bool adsrEnvelopeIsActive() const;
+	float getEnvelopeLevel() const;
+
+	// true once the note is released and its peak output level is below gain
+	bool isReleasedBelow(float gain) const;
 
 private:
 	//=============================================================================
-	juce::ADSR adsrEnvelope;
+	AdsrEnvelope adsrEnvelope;
 	juce::AudioBuffer<float> adsrScalars;
+	float envelopeLevel;
+	// envelope times velocity and volume on the last rendered sample
+	float appliedLevel;
+	bool envelopeIsReleasing;
+
+	enum RampScalarChannels
+	{
+		PhaseIncrementChannel = 0,
+		PanLeftChannel,
+		PanRightChannel,
+		BasePanCosChannel,
+		BasePanSinChannel,
+		NumRampScalarChannels
+	};
+	juce::AudioBuffer<float> rampScalars;
 
 	float sampleRate;
 
@@ -73,7 +121,6 @@ private:
 
 	float velocity;
 
-	float phases[MAX_DETUNE_VOICES];
 	float deltaPhase;
 
 	//=============================================================================
@@ -81,9 +128,42 @@ private:
 	float detuneMix;
 	float detuneSpread;
 
-	float detuneFrequencyCoefficients[MAX_DETUNE_VOICES];
-	float detuneVolumeCoefficients[MAX_DETUNE_VOICES];
-	float detunePanningOffsets[MAX_DETUNE_VOICES];
+	// one entry per detune voice; capacity for MAX_DETUNE_VOICES is reserved up front,
+	// so changing the voice count never allocates
+	std::vector<float> detuneFrequencyCoefficients;
+	std::vector<float> detuneVolumeCoefficients;
+	std::vector<float> detunePanningOffsets;
+
+	// per-voice offsets at full spread, used to follow a moving spread
+	std::vector<float> detuneFrequencyUnits;
+	std::vector<float> detunePanningUnits;
+
+	//=============================================================================
+	// UNISON LANES, detune voices padded to a whole number of SIMD registers
+	static constexpr int numUnisonLanes = (int) SimdFloat::SIMDNumElements;
+	static constexpr int maxPaddedDetuneVoices = (MAX_DETUNE_VOICES + numUnisonLanes - 1) / numUnisonLanes * numUnisonLanes;
+
+	alignas(16) float phases[maxPaddedDetuneVoices];
+	alignas(16) float unisonPhaseIncrements[maxPaddedDetuneVoices];
+	// each voice's level split into a centred (mid) and a side component around the base pan
+	alignas(16) float unisonGainsMid[maxPaddedDetuneVoices];
+	alignas(16) float unisonGainsSide[maxPaddedDetuneVoices];
+
+	// inner loops for the instruction set chosen at startup
+	const DspKernels *kernels;
+
+	//=============================================================================
+	// RENDER KERNELS, one instance of the render loop per interpolation mode, output layout
+	// and unison on or off; the instance is picked when one of those changes, so nothing
+	// inside the loop branches on them
+	using RenderKernel = void (Oscillator::*)(float *const *output, int startSample, int numSamples, const ParameterRamps &ramps);
+	static const RenderKernel renderKernels[NumInterpolationModes][2][2];
+
+	RenderKernel renderKernel;
+	int interpolationMode;
+	int numOutputChannels;
+
+	void updateRenderKernel();
 
 	//=============================================================================
 	const Wavetable *wavetable;
@@ -95,15 +175,32 @@ private:
 	float sampleOffset;
 
 	//=============================================================================
-	void incrementPhase(int);
+	template <typename Interpolation, bool isMono, bool isUnison>
+	void renderBlock(float *const *output, int startSample, int numSamples, const ParameterRamps &ramps);
+
+	template <typename Interpolation, bool isMono>
+	void renderVoice(float *const *output, int detuneVoice, int startSample, int numSamples);
+
+	template <typename Interpolation, bool isMono>
+	void renderUnison(float *const *output, int startSample, int numSamples, const ParameterRamps &ramps);
+
+	bool prepareUnisonLanes();
+
+	template <typename Interpolation, bool isMono>
+	void renderVoiceWithRamps(float *const *output, int detuneVoice, int startSample, int numSamples, const ParameterRamps &ramps);
+
+	void incrementPhase(int, float);
 	void updateDeltaPhase();
 
+	template <typename Interpolation>
 	float getNextSample();
 
+	void resizeDetuneVoices();
 	void calculateDetuneFrequencyCoefficients();
 	void calculateDetuneVolumeCoefficients();
 	void calculateDetunePanningOffsets();
 
+	bool isDetuneActive() const;
 	void applyRenderParameters(int);
 	void applyDetuneRenderParameters(int);
 	void applyBaseRenderParameters();
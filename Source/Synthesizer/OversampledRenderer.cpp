@@ -0,0 +1,289 @@
+#include "OversampledRenderer.h"
+
+//=============================================================================
+// CONSTRUCTORS / DESTRUCTORS
+
+OversampledRenderer::OversampledRenderer(Synthesizer &synthesizerToRender) :
+    synthesizer(synthesizerToRender)
+{
+    numStages = 0;
+    requestedNumStages = 0;
+    maximumNumStages = 0;
+    oversamplingFactor = 1;
+    outputSampleRate = 0.0;
+    latencyInSamples = 0;
+    fadingNumStages = -1;
+    fadingSamplesRemaining = 0;
+    maximumBlockSize = 0;
+    chunkSize = 0;
+    numOutputChannels = 2;
+    profiler = nullptr;
+}
+
+OversampledRenderer::~OversampledRenderer() {}
+
+//=============================================================================
+// CONFIGURATION
+
+// factors are rounded up to a power of two in [1, MAX_OVERSAMPLING_FACTOR]
+void OversampledRenderer::prepare(double newOutputSampleRate, int newMaximumBlockSize, int newOversamplingFactor, int newChunkSize,
+                                  int newNumOutputChannels, int maximumOversamplingFactor)
+{
+    const int initialNumStages = getNumStages(newOversamplingFactor);
+    maximumNumStages = juce::jmax(initialNumStages, getNumStages(maximumOversamplingFactor));
+    outputSampleRate = newOutputSampleRate;
+    maximumBlockSize = juce::jmax(1, newMaximumBlockSize);
+    chunkSize = newChunkSize > 0 ? juce::jmin(newChunkSize, maximumBlockSize) : maximumBlockSize;
+    numOutputChannels = juce::jlimit(1, 2, newNumOutputChannels);
+
+    // only the requested factor unless switching was asked for
+    latencyInSamples = 0;
+    for (int stages = 0; stages <= MAX_OVERSAMPLING_STAGES; stages++)
+    {
+        auto &chain = chains[stages];
+        chain.isPrepared = stages == initialNumStages || (stages <= maximumNumStages && maximumNumStages > initialNumStages);
+        chain.oversampling.reset();
+
+        if (chain.isPrepared && stages > 0)
+        {
+            chain.oversampling = std::make_unique<juce::dsp::Oversampling<float>>((size_t) numOutputChannels, (size_t) stages, juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR, true, false);
+            chain.oversampling->setUsingIntegerLatency(true);
+            chain.oversampling->initProcessing((size_t) chunkSize);
+            latencyInSamples = juce::jmax(latencyInSamples, getStageLatency(stages));
+        }
+    }
+
+    for (int stages = 0; stages <= MAX_OVERSAMPLING_STAGES; stages++)
+    {
+        auto &chain = chains[stages];
+        chain.latencyPaddingLength = chain.isPrepared ? latencyInSamples - getStageLatency(stages) : 0;
+        chain.latencyPadding.setSize(numOutputChannels, juce::jmax(1, chain.latencyPaddingLength));
+    }
+
+    fadingBuffer.setSize(numOutputChannels, chunkSize);
+
+    // the synthesizer is sized for the largest factor, so switching never allocates
+    synthesizer.prepare(chunkSize * (1 << maximumNumStages), numOutputChannels);
+
+    numStages = initialNumStages;
+    requestedNumStages = initialNumStages;
+    oversamplingFactor = 1 << numStages;
+    synthesizer.setSampleRate((float) (outputSampleRate * oversamplingFactor));
+    reset();
+}
+
+// clears every filter, so only for when nothing is being heard
+void OversampledRenderer::reset()
+{
+    for (auto &chain : chains)
+        resetChain(chain);
+
+    fadingNumStages = -1;
+    fadingSamplesRemaining = 0;
+}
+
+void OversampledRenderer::resetChain(OversamplingChain &chain)
+{
+    if (chain.oversampling != nullptr)
+        chain.oversampling->reset();
+
+    chain.latencyPadding.clear();
+    chain.latencyPaddingPosition = 0;
+}
+
+void OversampledRenderer::setOversamplingFactor(int newOversamplingFactor)
+{
+    const int newNumStages = juce::jmin(getNumStages(newOversamplingFactor), maximumNumStages);
+
+    // a factor between the requested one and the maximum may not have been prepared
+    jassert(chains[newNumStages].isPrepared);
+    if (chains[newNumStages].isPrepared)
+        requestedNumStages = newNumStages;
+}
+
+// the stages switched to have rested since they last played out, so the synthesizer's output
+// enters them as it would enter stages that had only ever seen silence. the stages switched
+// away from still hold up to latencyInSamples of output and get silence from here on; by
+// linearity their decay and the rise of the new stages add up to the filtered signal
+void OversampledRenderer::switchOversamplingFactor()
+{
+    if (requestedNumStages == numStages || fadingNumStages >= 0)
+        return;
+
+    fadingNumStages = numStages;
+    fadingSamplesRemaining = latencyInSamples + OVERSAMPLING_SWITCH_TAIL_SAMPLES;
+
+    numStages = requestedNumStages;
+    oversamplingFactor = 1 << numStages;
+
+    // the synthesizer renders at the rate of the block it is actually handed
+    synthesizer.setSampleRate((float) (outputSampleRate * oversamplingFactor));
+}
+
+int OversampledRenderer::getNumStages(int oversamplingFactor)
+{
+    return juce::jlimit(0, MAX_OVERSAMPLING_STAGES, (int) std::ceil(std::log2((double) juce::jmax(1, oversamplingFactor))));
+}
+
+// integer, since every stage chain is set to integer latency
+int OversampledRenderer::getStageLatency(int stages) const
+{
+    return chains[stages].oversampling != nullptr ? juce::roundToInt(chains[stages].oversampling->getLatencyInSamples()) : 0;
+}
+
+void OversampledRenderer::setProfiler(BlockProfiler *profilerToUse)
+{
+    profiler = profilerToUse;
+}
+
+int OversampledRenderer::getOversamplingFactor() const
+{
+    return oversamplingFactor;
+}
+
+// in output samples
+int OversampledRenderer::getChunkSize() const
+{
+    return chunkSize;
+}
+
+int OversampledRenderer::getNumOutputChannels() const
+{
+    return numOutputChannels;
+}
+
+// in output samples
+float OversampledRenderer::getLatencyInSamples() const
+{
+    return (float) latencyInSamples;
+}
+
+//=============================================================================
+// RENDER
+
+void OversampledRenderer::process(juce::AudioBuffer<float> &buffer, juce::MidiBuffer &midiMessages)
+{
+    jassert(buffer.getNumChannels() >= numOutputChannels);
+    jassert(buffer.getNumSamples() <= maximumBlockSize);
+
+    switchOversamplingFactor();
+
+    const int numSamples = buffer.getNumSamples();
+    auto midiIterator = midiMessages.cbegin();
+
+    for (int chunkStart = 0; chunkStart < numSamples; chunkStart += chunkSize)
+    {
+        const int chunkLength = juce::jmin(chunkSize, numSamples - chunkStart);
+        const auto chunkMidiEnd = findChunkMidiEnd(midiIterator, midiMessages.cend(), chunkStart + chunkLength, chunkStart + chunkLength >= numSamples);
+        processChunk(buffer, chunkStart, chunkLength, midiIterator, chunkMidiEnd);
+        midiIterator = chunkMidiEnd;
+
+        if (fadingNumStages >= 0)
+            processFadingChunk(buffer, chunkStart, chunkLength);
+    }
+}
+
+// the synthesizer reads the chunk's midi straight from the host buffer, offset to the chunk
+// start and scaled to the oversampled rate, so nothing is copied on the audio thread
+void OversampledRenderer::processChunk(juce::AudioBuffer<float> &buffer, int startSample, int numSamples,
+                                       juce::MidiBufferIterator midiBegin, juce::MidiBufferIterator midiEnd)
+{
+    auto &chain = chains[numStages];
+
+    if (chain.oversampling == nullptr)
+    {
+        float *channels[2] = { buffer.getWritePointer(0, startSample), nullptr };
+        if (numOutputChannels > 1)
+            channels[1] = buffer.getWritePointer(1, startSample);
+
+        juce::AudioBuffer<float> chunkBuffer{ channels, numOutputChannels, numSamples };
+        synthesizer.processBlock(chunkBuffer, midiBegin, midiEnd, startSample);
+        padLatency(chain, buffer, startSample, numSamples);
+        return;
+    }
+
+    auto block = juce::dsp::AudioBlock<float>(buffer).getSubsetChannelBlock(0, (size_t) numOutputChannels).getSubBlock((size_t) startSample, (size_t) numSamples);
+    juce::dsp::AudioBlock<float> oversampledBlock;
+    {
+        ScopedProfileStage profileStage(profiler, ProfileStage::OversampleUp);
+        oversampledBlock = chain.oversampling->processSamplesUp(block);
+    }
+
+    float *channels[2] = { oversampledBlock.getChannelPointer(0), nullptr };
+    if (numOutputChannels > 1)
+        channels[1] = oversampledBlock.getChannelPointer(1);
+
+    juce::AudioBuffer<float> oversampledBuffer{ channels, numOutputChannels, static_cast<int>(oversampledBlock.getNumSamples()) };
+
+    synthesizer.processBlock(oversampledBuffer, midiBegin, midiEnd, startSample, oversamplingFactor);
+
+    ScopedProfileStage profileStage(profiler, ProfileStage::OversampleDown);
+    chain.oversampling->processSamplesDown(block);
+    padLatency(chain, buffer, startSample, numSamples);
+}
+
+// the stages switched away from, run on silence and added to the chunk; once they have played
+// out they are cleared for the next switch, which nobody hears any more
+void OversampledRenderer::processFadingChunk(juce::AudioBuffer<float> &buffer, int startSample, int numSamples)
+{
+    ScopedProfileStage profileStage(profiler, ProfileStage::OversampleDown);
+    auto &chain = chains[fadingNumStages];
+
+    fadingBuffer.clear();
+    auto block = juce::dsp::AudioBlock<float>(fadingBuffer).getSubBlock(0, (size_t) numSamples);
+
+    if (chain.oversampling != nullptr)
+    {
+        chain.oversampling->processSamplesUp(block).clear();
+        chain.oversampling->processSamplesDown(block);
+    }
+
+    padLatency(chain, fadingBuffer, 0, numSamples);
+
+    for (int channel = 0; channel < numOutputChannels; ++channel)
+        buffer.addFrom(channel, startSample, fadingBuffer, channel, 0, numSamples);
+
+    fadingSamplesRemaining -= numSamples;
+    if (fadingSamplesRemaining <= 0)
+    {
+        resetChain(chain);
+        fadingNumStages = -1;
+    }
+}
+
+// a ring of latencyPaddingLength samples per channel; nothing to do for the slowest factor
+void OversampledRenderer::padLatency(OversamplingChain &chain, juce::AudioBuffer<float> &buffer, int startSample, int numSamples)
+{
+    if (chain.latencyPaddingLength <= 0)
+        return;
+
+    int position = chain.latencyPaddingPosition;
+    for (int channel = 0; channel < numOutputChannels; ++channel)
+    {
+        auto *samples = buffer.getWritePointer(channel, startSample);
+        auto *ring = chain.latencyPadding.getWritePointer(channel);
+
+        position = chain.latencyPaddingPosition;
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            std::swap(samples[sample], ring[position]);
+            if (++position == chain.latencyPaddingLength)
+                position = 0;
+        }
+    }
+
+    chain.latencyPaddingPosition = position;
+}
+
+// midi arrives in output sample positions of the host block, in time order; a chunk owns the
+// events before its end. the last chunk also takes anything past the block
+juce::MidiBufferIterator OversampledRenderer::findChunkMidiEnd(juce::MidiBufferIterator midiIterator, juce::MidiBufferIterator midiEnd, int chunkEnd, bool isLastChunk)
+{
+    if (isLastChunk)
+        return midiEnd;
+
+    while (midiIterator != midiEnd && (*midiIterator).samplePosition < chunkEnd)
+        ++midiIterator;
+
+    return midiIterator;
+}
@@ -0,0 +1,103 @@
+#ifndef OVERSAMPLED_RENDERER_H
+#define OVERSAMPLED_RENDERER_H
+
+#include <JuceHeader.h>
+#include "Synthesizer.h"
+#include "../Utilities/BlockProfiler.h"
+
+#define MAX_OVERSAMPLING_FACTOR 16
+#define MAX_OVERSAMPLING_STAGES 4
+
+// output samples per internal chunk; a chunk at 16x stays within l1 for every stage
+#define OVERSAMPLED_RENDER_CHUNK_SIZE 128
+
+// output samples the previous stages keep running after a factor switch, past their latency,
+// so the decay of their filters is heard rather than cut
+#define OVERSAMPLING_SWITCH_TAIL_SAMPLES 256
+
+// runs a Synthesizer at a power-of-two multiple of the output rate and filters the
+// result back down; shared by the plugin and every headless host of the dsp code.
+// host blocks are cut into fixed chunks that each go up, through the synthesizer and
+// back down before the next one starts, so the working set does not grow with the block
+class OversampledRenderer
+{
+public:
+
+	//=============================================================================
+	OversampledRenderer(Synthesizer &);
+	~OversampledRenderer();
+
+	//=============================================================================
+	// allocates, so never call from the audio thread; a chunk size of 0 or less renders
+	// whole host blocks at once. with one output channel every stage runs mono.
+	// a maximumOversamplingFactor above oversamplingFactor also prepares every factor up to
+	// it, so setOversamplingFactor can switch between them later
+	void prepare(double outputSampleRate, int maximumBlockSize, int oversamplingFactor, int chunkSize = OVERSAMPLED_RENDER_CHUNK_SIZE,
+	             int numOutputChannels = 2, int maximumOversamplingFactor = 0);
+	void reset();
+
+	// rendering thread, between blocks; never allocates. the factor is rounded as in prepare
+	// and limited to the prepared maximum, and takes over at the start of the next block.
+	// the previous stages are fed silence until they have played out what they hold, so the
+	// two overlap for their latency instead of cutting; a switch during that overlap waits
+	// for it to end. the latency does not change
+	void setOversamplingFactor(int);
+
+	void process(juce::AudioBuffer<float> &buffer, juce::MidiBuffer &midiMessages);
+
+	//=============================================================================
+	int getOversamplingFactor() const;
+	int getChunkSize() const;
+	int getNumOutputChannels() const;
+
+	// the same for every prepared factor: the faster ones are delayed to match the slowest
+	float getLatencyInSamples() const;
+
+	void setProfiler(BlockProfiler *);
+
+private:
+	//=============================================================================
+	Synthesizer &synthesizer;
+
+	// the filters of one factor, and a ring that pads their latency up to latencyInSamples
+	struct OversamplingChain
+	{
+		std::unique_ptr<juce::dsp::Oversampling<float>> oversampling;
+		juce::AudioBuffer<float> latencyPadding;
+		int latencyPaddingLength{ 0 };
+		int latencyPaddingPosition{ 0 };
+		bool isPrepared{ false };
+	};
+
+	// indexed by the number of stages; 1x has no filters, only padding
+	OversamplingChain chains[MAX_OVERSAMPLING_STAGES + 1];
+	int numStages;
+	int requestedNumStages;
+	int maximumNumStages;
+	int oversamplingFactor;
+	double outputSampleRate;
+	int latencyInSamples;
+
+	// the stages switched away from, fed silence until fadingSamplesRemaining runs out; -1 if none
+	int fadingNumStages;
+	int fadingSamplesRemaining;
+	juce::AudioBuffer<float> fadingBuffer;
+	int maximumBlockSize;
+	int chunkSize;
+	int numOutputChannels;
+
+	BlockProfiler *profiler;
+
+	//=============================================================================
+	void processChunk(juce::AudioBuffer<float> &buffer, int startSample, int numSamples,
+	                  juce::MidiBufferIterator midiBegin, juce::MidiBufferIterator midiEnd);
+	void processFadingChunk(juce::AudioBuffer<float> &buffer, int startSample, int numSamples);
+	void padLatency(OversamplingChain &chain, juce::AudioBuffer<float> &buffer, int startSample, int numSamples);
+	void resetChain(OversamplingChain &chain);
+	void switchOversamplingFactor();
+	static int getNumStages(int oversamplingFactor);
+	int getStageLatency(int numStages) const;
+	static juce::MidiBufferIterator findChunkMidiEnd(juce::MidiBufferIterator midiIterator, juce::MidiBufferIterator midiEnd, int chunkEnd, bool isLastChunk);
+};
+
+#endif // OVERSAMPLED_RENDERER_H
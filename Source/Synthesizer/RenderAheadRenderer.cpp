@@ -0,0 +1,229 @@
+#include "RenderAheadRenderer.h"
+
+//=============================================================================
+// CONSTRUCTORS / DESTRUCTORS
+
+RenderAheadRenderer::RenderAheadRenderer(OversampledRenderer &rendererToRun) :
+    juce::Thread("WavetableSynth Render Ahead"),
+    renderer(rendererToRun)
+{
+    blockSize = 0;
+    latencyInSamples = 0;
+    hostPosition = 0;
+    numLateFrames = 0;
+    renderPosition = 0;
+}
+
+RenderAheadRenderer::~RenderAheadRenderer()
+{
+    release();
+}
+
+//=============================================================================
+// CONFIGURATION
+
+// the render thread keeps numBlocksAhead blocks queued on top of the one the host is
+// about to take, so the added latency is (numBlocksAhead + 1) blocks
+void RenderAheadRenderer::prepare(int maximumBlockSize, int numBlocksAhead)
+{
+    release();
+
+    blockSize = juce::jmax(1, maximumBlockSize);
+    latencyInSamples = blockSize * (juce::jlimit(1, MAX_RENDER_AHEAD_BLOCKS, numBlocksAhead) + 1);
+
+    frames.prepare(latencyInSamples);
+    midiEvents.prepare(RENDER_AHEAD_MIDI_FIFO_SIZE);
+    numUnderruns.store(0);
+
+    renderBuffer.setSize(renderer.getNumOutputChannels(), blockSize);
+    renderMidi.ensureSize(RENDER_AHEAD_MIDI_BUFFER_BYTES);
+    renderFrames.allocate((size_t) blockSize, true);
+
+    hostPosition = 0;
+    numLateFrames = 0;
+    renderPosition = 0;
+    framesConsumed.reset();
+    framesRendered.reset();
+
+    // the audio thread's priority, so the headroom is only spent on real spikes
+    if (!startRealtimeThread(juce::Thread::RealtimeOptions{}.withPriority(9)))
+        startThread(juce::Thread::Priority::highest);
+}
+
+void RenderAheadRenderer::release()
+{
+    signalThreadShouldExit();
+    framesConsumed.signal();
+    framesRendered.signal();
+    stopThread(1000);
+    latencyInSamples = 0;
+}
+
+bool RenderAheadRenderer::isActive() const
+{
+    return latencyInSamples > 0;
+}
+
+// in output samples, on top of the oversampled renderer's own latency
+int RenderAheadRenderer::getLatencyInSamples() const
+{
+    return latencyInSamples;
+}
+
+int RenderAheadRenderer::getNumUnderruns() const
+{
+    return numUnderruns.load(std::memory_order_relaxed);
+}
+
+//=============================================================================
+// AUDIO THREAD
+
+void RenderAheadRenderer::process(juce::AudioBuffer<float> &buffer, const juce::MidiBuffer &midiMessages, bool waitForFrames)
+{
+    jassert(buffer.getNumChannels() >= renderBuffer.getNumChannels());
+    jassert(buffer.getNumSamples() <= blockSize);
+
+    // stamp each event with the output sample it belongs to once the latency is added
+    for (const auto midiData : midiMessages)
+    {
+        if (midiData.numBytes > 3)
+            continue;
+
+        RenderAheadMidiEvent event;
+        event.samplePosition = hostPosition + midiData.samplePosition + latencyInSamples;
+        event.numBytes = midiData.numBytes;
+        std::copy(midiData.data, midiData.data + midiData.numBytes, event.data);
+        midiEvents.push(&event, 1);
+    }
+
+    auto *left = buffer.getWritePointer(0);
+    auto *right = buffer.getNumChannels() > 1 ? buffer.getWritePointer(1) : nullptr;
+    const int numSamples = buffer.getNumSamples();
+
+    // the render thread may be asleep waiting for space, so wake it before waiting on it
+    if (waitForFrames)
+    {
+        while (isThreadRunning() && !threadShouldExit())
+        {
+            skipLateFrames();
+            if (numLateFrames == 0 && frames.getNumReady() >= numSamples)
+                break;
+
+            framesConsumed.signal();
+            framesRendered.wait(RENDER_AHEAD_WAIT_MS);
+        }
+    }
+
+    skipLateFrames();
+
+    int numCopied = 0;
+    RenderAheadFrame frameChunk[64];
+    while (numCopied < numSamples)
+    {
+        const int numPopped = frames.pop(frameChunk, juce::jmin(64, numSamples - numCopied));
+        if (numPopped == 0)
+            break;
+
+        for (int frame = 0; frame < numPopped; ++frame)
+        {
+            left[numCopied + frame] = frameChunk[frame].left;
+        }
+
+        if (right != nullptr)
+        {
+            for (int frame = 0; frame < numPopped; ++frame)
+            {
+                right[numCopied + frame] = frameChunk[frame].right;
+            }
+        }
+        numCopied += numPopped;
+    }
+
+    // the render thread fell behind: play silence for the gap and skip those frames once
+    // they arrive, so the output stays exactly the reported latency behind the midi
+    if (numCopied < numSamples)
+    {
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            buffer.clear(channel, numCopied, numSamples - numCopied);
+        numLateFrames += numSamples - numCopied;
+        numUnderruns.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    hostPosition += numSamples;
+    framesConsumed.signal();
+}
+
+// the render thread renders every frame in order, late or not, so the synthesizer's voices
+// and the midi timeline carry on as if it had kept up
+void RenderAheadRenderer::skipLateFrames()
+{
+    RenderAheadFrame frameChunk[64];
+    while (numLateFrames > 0)
+    {
+        const int numPopped = frames.pop(frameChunk, (int) juce::jmin((juce::int64) 64, numLateFrames));
+        if (numPopped == 0)
+            break;
+
+        numLateFrames -= numPopped;
+    }
+}
+
+//=============================================================================
+// RENDER THREAD
+
+void RenderAheadRenderer::run()
+{
+    juce::ScopedNoDenormals noDenormals;
+
+    while (!threadShouldExit())
+    {
+        // a block is only started once every sample in it is at least the latency
+        // away from the host, so no event for it can still be on its way
+        while (!threadShouldExit() && frames.getCapacity() - frames.getFreeSpace() + blockSize <= latencyInSamples)
+        {
+            renderBlock();
+        }
+
+        framesConsumed.wait(RENDER_AHEAD_WAIT_MS);
+    }
+}
+
+void RenderAheadRenderer::renderBlock()
+{
+    if (onBeforeRender)
+        onBeforeRender();
+
+    collectMidiForBlock();
+
+    renderBuffer.clear();
+    renderer.process(renderBuffer, renderMidi);
+
+    if (onRendered)
+        onRendered(renderBuffer);
+
+    // a mono render fills both sides of the frame with the one channel
+    const auto *left = renderBuffer.getReadPointer(0);
+    const auto *right = renderBuffer.getReadPointer(renderBuffer.getNumChannels() - 1);
+    for (int sample = 0; sample < blockSize; ++sample)
+    {
+        renderFrames[sample] = { left[sample], right[sample] };
+    }
+
+    frames.push(renderFrames, blockSize);
+    renderPosition += blockSize;
+    framesRendered.signal();
+}
+
+// events are queued in time order, so only the front of the fifo can be due
+void RenderAheadRenderer::collectMidiForBlock()
+{
+    renderMidi.clear();
+
+    RenderAheadMidiEvent event;
+    while (midiEvents.peek(&event, 1) == 1 && event.samplePosition < renderPosition + blockSize)
+    {
+        const int position = (int) juce::jlimit((juce::int64) 0, (juce::int64) blockSize - 1, event.samplePosition - renderPosition);
+        renderMidi.addEvent(event.data, event.numBytes, position);
+        midiEvents.pop(&event, 1);
+    }
+}
@@ -0,0 +1,103 @@
+#ifndef RENDER_AHEAD_RENDERER_H
+#define RENDER_AHEAD_RENDERER_H
+
+#include <JuceHeader.h>
+#include "OversampledRenderer.h"
+#include "../Utilities/SpscRingBuffer.h"
+#include "../Utilities/WakeEvent.h"
+
+#define MAX_RENDER_AHEAD_BLOCKS 8
+#define RENDER_AHEAD_MIDI_FIFO_SIZE 2048
+
+// room for a full fifo in the render thread's MidiBuffer, which stores a 4 byte position and
+// a 2 byte length ahead of each message, so collecting a block's midi never grows it
+#define RENDER_AHEAD_MIDI_BUFFER_BYTES (RENDER_AHEAD_MIDI_FIFO_SIZE * (4 + 2 + 3))
+#define RENDER_AHEAD_WAIT_MS 5
+
+// one short midi message stamped with the output sample it must be heard at
+struct RenderAheadMidiEvent
+{
+	juce::int64 samplePosition;
+	juce::uint8 data[3];
+	int numBytes;
+};
+
+struct RenderAheadFrame
+{
+	float left;
+	float right;
+};
+
+// runs an OversampledRenderer on its own high priority thread, a fixed number of blocks
+// ahead of the host. the host callback only queues midi and copies finished audio out, so
+// a burst of expensive blocks is absorbed by the headroom instead of causing an xrun.
+// audio and midi are delayed by exactly getLatencyInSamples(), which the owner must report
+// to the host; audio that is not ready in time is replaced by silence, never played late
+class RenderAheadRenderer : private juce::Thread
+{
+public:
+
+	//=============================================================================
+	RenderAheadRenderer(OversampledRenderer &);
+	~RenderAheadRenderer() override;
+
+	//=============================================================================
+	// allocates and starts the render thread, so never call from the audio thread;
+	// the renderer must already be prepared for maximumBlockSize
+	void prepare(int maximumBlockSize, int numBlocksAhead);
+	void release();
+
+	bool isActive() const;
+	int getLatencyInSamples() const;
+
+	// blocks the host asked for that were not rendered in time
+	int getNumUnderruns() const;
+
+	//=============================================================================
+	// called on the render thread, before and after every block it renders; set these
+	// before prepare(). anything that touches the synthesizer belongs here, not in the
+	// host callback
+	std::function<void()> onBeforeRender;
+	std::function<void(const juce::AudioBuffer<float> &)> onRendered;
+
+	//=============================================================================
+	// AUDIO THREAD
+
+	// with waitForFrames, as in a bounce where the host does not wait for realtime, blocks
+	// until the render thread has the whole block instead of playing silence for the gap
+	void process(juce::AudioBuffer<float> &buffer, const juce::MidiBuffer &midiMessages, bool waitForFrames = false);
+
+private:
+	//=============================================================================
+	OversampledRenderer &renderer;
+
+	int blockSize;
+	int latencyInSamples;
+
+	SpscRingBuffer<RenderAheadFrame> frames;
+	SpscRingBuffer<RenderAheadMidiEvent> midiEvents;
+	WakeEvent framesConsumed;
+	WakeEvent framesRendered;
+	std::atomic<int> numUnderruns{ 0 };
+
+	// audio thread: output samples handed to the host so far, and the frames still to come
+	// that were due in an earlier block, played as silence then and skipped when they arrive
+	juce::int64 hostPosition;
+	juce::int64 numLateFrames;
+
+	// render thread: output samples rendered so far, and the block being rendered
+	juce::int64 renderPosition;
+	juce::AudioBuffer<float> renderBuffer;
+	juce::MidiBuffer renderMidi;
+	juce::HeapBlock<RenderAheadFrame> renderFrames;
+
+	//=============================================================================
+	void skipLateFrames();
+	void run() override;
+	void renderBlock();
+	void collectMidiForBlock();
+
+	JUCE_DECLARE_NON_COPYABLE(RenderAheadRenderer)
+};
+
+#endif // RENDER_AHEAD_RENDERER_H
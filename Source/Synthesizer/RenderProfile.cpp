@@ -0,0 +1,72 @@
+#include "RenderProfile.h"
+#include "Synthesizer.h"
+
+static const char *const renderProfileParameterIds[NumRenderProfiles][NumRenderProfileSettings] = {
+    { "REALTIME_OVERSAMPLING", "REALTIME_INTERPOLATION", "REALTIME_UNISON_CAP", "REALTIME_MULTITHREADED" },
+    { "OFFLINE_OVERSAMPLING", "OFFLINE_INTERPOLATION", "OFFLINE_UNISON_CAP", "OFFLINE_MULTITHREADED" }
+};
+
+// a bounce does not have to keep up with realtime, so it gets more oversampling and the windowed sinc
+RenderProfile getDefaultRenderProfile(int profile)
+{
+    RenderProfile defaults;
+
+    if (profile == OfflineRenderProfile)
+    {
+        defaults.oversamplingFactor = OFFLINE_OVERSAMPLING_FACTOR;
+        defaults.interpolationMode = OFFLINE_INTERPOLATION_MODE;
+    }
+
+    return defaults;
+}
+
+const char *getRenderProfileParameterId(int profile, int setting)
+{
+    jassert(profile >= 0 && profile < NumRenderProfiles);
+    jassert(setting >= 0 && setting < NumRenderProfileSettings);
+    return renderProfileParameterIds[profile][setting];
+}
+
+juce::StringArray getOversamplingChoices()
+{
+    juce::StringArray choices;
+    for (int factor = 1; factor <= MAX_OVERSAMPLING_FACTOR; factor *= 2)
+        choices.add(juce::String(factor) + "x");
+
+    return choices;
+}
+
+// factors that are not a power of two round down to one
+int getOversamplingChoiceIndex(int oversamplingFactor)
+{
+    int index = 0;
+    while ((2 << index) <= juce::jmin(oversamplingFactor, MAX_OVERSAMPLING_FACTOR))
+        index++;
+
+    return index;
+}
+
+#if JUCE_MODULE_AVAILABLE_juce_audio_processors
+RenderProfile getRenderProfileFromValueTree(juce::AudioProcessorValueTreeState& valueTree, int profile)
+{
+    auto load = [&valueTree, profile](int setting) {
+        return valueTree.getRawParameterValue(getRenderProfileParameterId(profile, setting))->load();
+    };
+
+    RenderProfile renderProfile;
+
+    renderProfile.oversamplingFactor = 1 << juce::roundToInt(load(RenderProfileOversampling));
+    renderProfile.interpolationMode = juce::roundToInt(load(RenderProfileInterpolation));
+    renderProfile.unisonVoiceLimit = juce::roundToInt(load(RenderProfileUnisonCap));
+    renderProfile.multithreaded = load(RenderProfileMultithreaded) >= 0.5f;
+
+    return renderProfile;
+}
+#endif
+
+void applyRenderProfile(Synthesizer& synthesizer, const RenderProfile& profile)
+{
+    synthesizer.setInterpolationMode(profile.interpolationMode);
+    synthesizer.setUnisonVoiceLimit(profile.unisonVoiceLimit);
+    synthesizer.setMultithreaded(profile.multithreaded);
+}
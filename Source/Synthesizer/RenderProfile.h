@@ -0,0 +1,60 @@
+#ifndef RENDER_PROFILE_H
+#define RENDER_PROFILE_H
+
+#include <JuceHeader.h>
+#include "OversampledRenderer.h"
+
+class Synthesizer;
+
+#define REALTIME_OVERSAMPLING_FACTOR 4
+#define OFFLINE_OVERSAMPLING_FACTOR 8
+
+enum RenderProfiles {
+    RealtimeRenderProfile = 0,
+    OfflineRenderProfile,
+    NumRenderProfiles
+};
+
+enum RenderProfileSettings {
+    RenderProfileOversampling = 0,
+    RenderProfileInterpolation,
+    RenderProfileUnisonCap,
+    RenderProfileMultithreaded,
+    NumRenderProfileSettings
+};
+
+// how much cpu the engine spends on quality; the plugin keeps one profile for live playback
+// and one for bounces and follows the host's non-realtime flag
+struct RenderProfile
+{
+    // a power of two up to MAX_OVERSAMPLING_FACTOR
+    int  oversamplingFactor{ REALTIME_OVERSAMPLING_FACTOR };
+
+    // one of InterpolationModes
+    int  interpolationMode{ InterpolationHermite };
+
+    // unison voices rendered at most, whatever the patch asks for
+    int  unisonVoiceLimit{ MAX_DETUNE_VOICES };
+
+    bool multithreaded{ true };
+};
+
+// the defaults of the plugin's parameter layout
+RenderProfile getDefaultRenderProfile(int profile);
+
+// e.g. OFFLINE_OVERSAMPLING; a literal, so reading it on the audio thread does not allocate
+const char *getRenderProfileParameterId(int profile, int setting);
+
+// the oversampling parameter is a choice of 1x, 2x, 4x ... MAX_OVERSAMPLING_FACTOR
+juce::StringArray getOversamplingChoices();
+int getOversamplingChoiceIndex(int oversamplingFactor);
+
+#if JUCE_MODULE_AVAILABLE_juce_audio_processors
+RenderProfile getRenderProfileFromValueTree(juce::AudioProcessorValueTreeState& valueTree, int profile);
+#endif
+
+// everything but the oversampling factor, which goes to OversampledRenderer::setOversamplingFactor;
+// safe between blocks on the audio thread
+void applyRenderProfile(Synthesizer& synthesizer, const RenderProfile& profile);
+
+#endif // RENDER_PROFILE_H
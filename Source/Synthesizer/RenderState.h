@@ -0,0 +1,20 @@
+#ifndef RENDER_STATE_H
+#define RENDER_STATE_H
+
+#include <JuceHeader.h>
+#include "Synthesizer.h"
+
+// read-only snapshot of the audio thread's render state, published once per
+// block so the editor never has to touch live DSP objects
+struct RenderState
+{
+	int   wavetableFrameIndex{ 0 };
+	int   numWavetableFrames{ 0 };
+
+	int   numActiveVoices{ 0 };
+	float envelopeLevels[MAX_POLYPHONY]{};
+
+	float outputPeak{ 0.f };
+};
+
+#endif // RENDER_STATE_H
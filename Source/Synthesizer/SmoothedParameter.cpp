@@ -0,0 +1,143 @@
+#include "SmoothedParameter.h"
+
+//=============================================================================
+// CONSTRUCTORS / DESTRUCTORS
+
+SmoothedParameter::SmoothedParameter()
+{
+    sampleRate = 44100.f;
+    rampLengthSeconds = 0.f;
+    rampLengthSamples = 0;
+
+    currentValue = 0.f;
+    targetValue = 0.f;
+    stepSize = 0.f;
+    rampSamplesRemaining = 0;
+
+    hasValue = false;
+    ramping = false;
+}
+
+SmoothedParameter::~SmoothedParameter() {}
+
+//=============================================================================
+// CONFIGURATION
+
+// allocate ramp storage; must be called off the audio thread
+void SmoothedParameter::prepare(int maximumBlockSize)
+{
+    rampBuffer.setSize(1, juce::jmax(1, maximumBlockSize), false, true, false);
+    ramping = false;
+}
+
+void SmoothedParameter::setSampleRate(float newSampleRate)
+{
+    if (newSampleRate == sampleRate)
+        return;
+
+    sampleRate = juce::jmax(1.f, newSampleRate);
+    updateRampLengthSamples();
+}
+
+void SmoothedParameter::setRampLengthSeconds(float newRampLengthSeconds)
+{
+    rampLengthSeconds = juce::jmax(0.f, newRampLengthSeconds);
+    updateRampLengthSamples();
+}
+
+void SmoothedParameter::updateRampLengthSamples()
+{
+    rampLengthSamples = juce::roundToInt(rampLengthSeconds * sampleRate);
+}
+
+//=============================================================================
+// VALUE
+
+// jump straight to a value without ramping
+void SmoothedParameter::setCurrentAndTargetValue(float newValue)
+{
+    currentValue = newValue;
+    targetValue = newValue;
+    stepSize = 0.f;
+    rampSamplesRemaining = 0;
+    hasValue = true;
+}
+
+// start a ramp from the current value; the first value ever set is applied immediately
+void SmoothedParameter::setTargetValue(float newValue)
+{
+    if (!hasValue || rampLengthSamples <= 0)
+    {
+        setCurrentAndTargetValue(newValue);
+        return;
+    }
+
+    if (newValue == targetValue)
+        return;
+
+    targetValue = newValue;
+    rampSamplesRemaining = rampLengthSamples;
+    stepSize = (targetValue - currentValue) / (float) rampLengthSamples;
+}
+
+float SmoothedParameter::getTargetValue() const
+{
+    return targetValue;
+}
+
+//=============================================================================
+// RENDER
+
+// render the next numSamples values of the ramp; when the parameter is settled the
+// buffer is left untouched and isRamping() reports false so callers take the constant path
+void SmoothedParameter::renderBlock(int numSamples)
+{
+    ramping = false;
+
+    if (rampSamplesRemaining <= 0 || numSamples <= 0)
+        return;
+
+    // a block larger than prepared cannot hold the ramp; finish it instantly instead
+    if (numSamples > rampBuffer.getNumSamples())
+    {
+        jassertfalse;
+        setCurrentAndTargetValue(targetValue);
+        return;
+    }
+
+    auto *ramp = rampBuffer.getWritePointer(0);
+    const int numRampSamples = juce::jmin(numSamples, rampSamplesRemaining);
+    const float startValue = currentValue;
+    const float step = stepSize;
+
+    // independent iterations so the compiler can vectorize the fill
+    for (int sampleIndex = 0; sampleIndex < numRampSamples; ++sampleIndex)
+    {
+        ramp[sampleIndex] = startValue + step * (float) (sampleIndex + 1);
+    }
+
+    rampSamplesRemaining -= numRampSamples;
+
+    if (rampSamplesRemaining > 0)
+    {
+        currentValue = ramp[numRampSamples - 1];
+    }
+    else
+    {
+        currentValue = targetValue;
+        juce::FloatVectorOperations::fill(ramp + numRampSamples - 1, targetValue, numSamples - numRampSamples + 1);
+    }
+
+    ramping = true;
+}
+
+bool SmoothedParameter::isRamping() const
+{
+    return ramping;
+}
+
+// ramp values for the block last passed to renderBlock, offset to startSample
+const float *SmoothedParameter::getRampPointer(int startSample) const
+{
+    return rampBuffer.getReadPointer(0) + startSample;
+}
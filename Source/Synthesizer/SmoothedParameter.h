@@ -0,0 +1,51 @@
+#ifndef SMOOTHED_PARAMETER_H
+#define SMOOTHED_PARAMETER_H
+
+#include <JuceHeader.h>
+
+// linearly ramps a parameter towards its target, rendering one ramp per block
+// while the value is moving so the render kernels can read it sample by sample
+class SmoothedParameter
+{
+public:
+
+	//=============================================================================
+	SmoothedParameter();
+	~SmoothedParameter();
+
+	//=============================================================================
+	void prepare(int maximumBlockSize);
+	void setSampleRate(float);
+	void setRampLengthSeconds(float);
+
+	void setCurrentAndTargetValue(float);
+	void setTargetValue(float);
+
+	//=============================================================================
+	void renderBlock(int numSamples);
+
+	bool isRamping() const;
+	float getTargetValue() const;
+	const float *getRampPointer(int startSample) const;
+
+private:
+	//=============================================================================
+	juce::AudioBuffer<float> rampBuffer;
+
+	float sampleRate;
+	float rampLengthSeconds;
+	int rampLengthSamples;
+
+	float currentValue;
+	float targetValue;
+	float stepSize;
+	int rampSamplesRemaining;
+
+	bool hasValue;
+	bool ramping;
+
+	//=============================================================================
+	void updateRampLengthSamples();
+};
+
+#endif // SMOOTHED_PARAMETER_H
@@ -1,4 +1,5 @@
 #include "Synthesizer.h"
+#include "RenderState.h"
 
 inline int clampInt (int input, int lowerBound, int upperBound)
 {
@@ -20,6 +21,8 @@ Synthesizer::Synthesizer()
     wavetableSize = 0;
     wavetableNumFrames = 0;
     wavetableFrameIndex = 0;
+    wavetable = std::make_shared<const Wavetable>();
+    interpolationMode = InterpolationHermite;
 
     // initialize oscillators
     updateOscillators();
@@ -33,15 +36,34 @@ Synthesizer::Synthesizer()
     pan = 0.f;
 
     detuneVoices = 5;
+    unisonVoiceLimit = MAX_DETUNE_VOICES;
     detuneMix = 1.f;
     detuneSpread = 1.f;
 
+    setVoiceSilenceThreshold(DEFAULT_VOICE_SILENCE_THRESHOLD_DB);
+
     voiceStealingEnabled = true;
+    kernels = &getDspKernels();
+    profiler = nullptr;
+    workerPool = nullptr;
+    multithreaded = true;
+    voiceBufferSize = 0;
+    voiceRenderBatch.synthesizer = this;
+
+    randomSeed = 0;
+    hasRandomSeed = false;
 
     pitchBendWheelPosition = 0;
     pitchBendUpperBoundSemitones = 2;
     pitchBendLowerBoundSemitones = -2;
 
+    // initialize parameter smoothing
+    for (auto *smoother : { &volumeSmoother, &panSmoother, &detuneSpreadSmoother })
+    {
+        smoother->setSampleRate(sampleRate);
+        smoother->setRampLengthSeconds(PARAMETER_SMOOTHING_SECONDS);
+    }
+
     // initialize voices
     int voiceId = 0;
     for (auto &voice : voices)
@@ -62,6 +84,12 @@ float Synthesizer::getSampleRate() const
 void Synthesizer::setSampleRate(float newSampleRate)
 {
     this->sampleRate = clampFloat(newSampleRate, 0.f, FLT_MAX);
+
+    volumeSmoother.setSampleRate(sampleRate);
+    panSmoother.setSampleRate(sampleRate);
+    detuneSpreadSmoother.setSampleRate(sampleRate);
+
+    filterBank.setSampleRate(sampleRate);
 }
 
 // [0, 20k]
@@ -80,12 +108,21 @@ void Synthesizer::setFrequencyByMidiNote(int midiNoteNumber, float pitchWheelPos
 void Synthesizer::setVolume(float newVolume)
 {
     this->volume = clampFloat(newVolume, 0.f, 1.f);
+    volumeSmoother.setTargetValue(volume);
 }
 
 // [-1, 1]
 void Synthesizer::setPan(float newPan)
 {
     this->pan = clampFloat(newPan, -1.f, 1.f);
+    panSmoother.setTargetValue(pan);
+}
+
+// [MIN_VOICE_SILENCE_THRESHOLD_DB, 0] dBFS
+void Synthesizer::setVoiceSilenceThreshold(float decibels)
+{
+    decibels = clampFloat(decibels, MIN_VOICE_SILENCE_THRESHOLD_DB, 0.f);
+    this->voiceSilenceThresholdGain = juce::Decibels::decibelsToGain(decibels, MIN_VOICE_SILENCE_THRESHOLD_DB - 1.f);
 }
 
 //=============================================================================
@@ -123,6 +160,12 @@ void Synthesizer::setDetuneVoices(int newNumVoices)
     this->detuneVoices = clampInt(newNumVoices, 1, MAX_DETUNE_VOICES);
 };
 
+// [1, MAX_DETUNE_VOICES]
+void Synthesizer::setUnisonVoiceLimit(int newLimit)
+{
+    this->unisonVoiceLimit = clampInt(newLimit, 1, MAX_DETUNE_VOICES);
+}
+
 // [0, 1]
 void Synthesizer::setDetuneMix(float newDetuneMix)
 {
@@ -133,6 +176,25 @@ void Synthesizer::setDetuneMix(float newDetuneMix)
 void Synthesizer::setDetuneSpread(float newDetuneSpread)
 {
     this->detuneSpread = clampFloat(newDetuneSpread, 0.f, 1.f);
+    detuneSpreadSmoother.setTargetValue(detuneSpread);
+}
+
+//=============================================================================
+// INTERPOLATION PARAMETERS
+
+// [0, NumInterpolationModes); oscillators pick it up at the start of the next block
+void Synthesizer::setInterpolationMode(int newInterpolationMode)
+{
+    this->interpolationMode = clampInt(newInterpolationMode, 0, NumInterpolationModes - 1);
+}
+
+//=============================================================================
+// FILTER PARAMETERS
+
+// mode is one of FilterModes; see VoiceFilterBank::setParameters for the ranges
+void Synthesizer::setFilterParameters(int mode, float cutoffHz, float resonance, float envelopeAmount, float keyTracking)
+{
+    filterBank.setParameters(mode, cutoffHz, resonance, envelopeAmount, keyTracking);
 }
 
 //=============================================================================
@@ -140,25 +202,33 @@ void Synthesizer::setDetuneSpread(float newDetuneSpread)
 
 const Wavetable *Synthesizer::getWavetableReadPointer() const
 {
-    return &wavetable;
+    return wavetable.get();
 }
 
 int Synthesizer::getNumWavetableFrames() const
 {
-    return wavetable.getNumChannels();
+    return wavetable->getNumChannels();
 }
 
 void Synthesizer::setWavetable(Wavetable &wavetableToCopy)
 {
-	wavetable = wavetableToCopy;
+    setWavetable(std::make_shared<const Wavetable>(wavetableToCopy));
+}
+
+// the table is never written after this, so any number of synthesizers may share it
+void Synthesizer::setWavetable(std::shared_ptr<const Wavetable> wavetableToShare)
+{
+    TRACE_SCOPE("Synthesizer::setWavetable");
+    jassert(wavetableToShare != nullptr);
+    wavetable = std::move(wavetableToShare);
 
     for (auto &oscillator : oscillators)
     {
         oscillator.setWavetable(getWavetableReadPointer());
     }
 
-    wavetableSize = wavetable.getNumSamples();
-    wavetableNumFrames = wavetable.getNumChannels();
+    wavetableSize = wavetable->getNumSamples();
+    wavetableNumFrames = wavetable->getNumChannels();
 }
 
 void Synthesizer::setWavetableFrameIndex(int newFrameIndex)
@@ -185,6 +255,7 @@ void Synthesizer::updateOscillator(Oscillator &oscillator)
 
     oscillator.setWavetable(getWavetableReadPointer());
     oscillator.setWavetableFrameIndex(wavetableFrameIndex);
+    oscillator.setInterpolationMode(interpolationMode);
 
     updateOscillatorDetuneParameters(oscillator);
 }
@@ -193,38 +264,90 @@ void Synthesizer::updateOscillator(Oscillator &oscillator)
 // if and only if synthesizer detune parameters changed
 void Synthesizer::updateOscillatorDetuneParameters(Oscillator &oscillator)
 {
-    if (oscillator.getDetuneVoices() != detuneVoices ||
+    const int renderedDetuneVoices = getRenderedDetuneVoices();
+    if (oscillator.getDetuneVoices() != renderedDetuneVoices ||
         oscillator.getDetuneMix() != detuneMix ||
         oscillator.getDetuneSpread() != detuneSpread)
     {
-        oscillator.setDetuneVoices(detuneVoices);
+        oscillator.setDetuneVoices(renderedDetuneVoices);
         oscillator.setDetuneMix(detuneMix);
         oscillator.setDetuneSpread(detuneSpread);
         oscillator.updateDetuneVoiceConfiguration();
     }
 }
 
+int Synthesizer::getRenderedDetuneVoices() const
+{
+    return juce::jmin(detuneVoices, unisonVoiceLimit);
+}
+
 //=============================================================================
 // RENDERING
 
+// allocate per-block buffers; must be called before rendering and off the audio thread
+void Synthesizer::prepare(int maximumBlockSize, int numOutputChannels)
+{
+    jassert(numOutputChannels == 1 || numOutputChannels == 2);
+
+    // the sinc tables are built on first use, which must not be on the audio thread
+    prepareSincCoefficients();
+
+    for (auto &oscillator : oscillators)
+    {
+        oscillator.prepare(maximumBlockSize, numOutputChannels);
+    }
+
+    volumeSmoother.prepare(maximumBlockSize);
+    panSmoother.prepare(maximumBlockSize);
+    detuneSpreadSmoother.prepare(maximumBlockSize);
+
+    for (auto &voiceBuffer : voiceBuffers)
+    {
+        voiceBuffer.setSize(juce::jlimit(1, 2, numOutputChannels), maximumBlockSize);
+    }
+    voiceBufferSize = maximumBlockSize;
+
+    if (workerPool != nullptr)
+        voiceTaskGroup.prepare(MAX_POLYPHONY);
+
+    filterBank.reset();
+
+    if (hasRandomSeed)
+        phaseRandom.setSeed(randomSeed);
+}
+
 void Synthesizer::processBlock(juce::AudioBuffer<float> &buffer, juce::MidiBuffer &midiBuffer)
 {
+    processBlock(buffer, midiBuffer.cbegin(), midiBuffer.cend());
+}
+
+void Synthesizer::processBlock(juce::AudioBuffer<float> &buffer, juce::MidiBufferIterator midiBegin, juce::MidiBufferIterator midiEnd,
+                               int firstMidiSample, int midiScale)
+{
+    jassert(midiScale >= 1);
+
     auto currentSample = 0;
+    const int lastMidiSample = (buffer.getNumSamples() - 1) / midiScale;
 
-    updateOscillators();
+    {
+        ScopedProfileStage profileStage(profiler, ProfileStage::ParameterUpdate);
+        updateOscillators();
+        renderParameterRamps(buffer.getNumSamples());
+    }
 
-    for (const auto midiData : midiBuffer)
+    for (auto midiIterator = midiBegin; midiIterator != midiEnd; ++midiIterator)
     {
-        // get next midi message timestamp
-        const auto midiMessage = midiData.getMessage();
-        const auto midiMessagePosition = static_cast<int>(midiMessage.getTimeStamp());
+        // get next midi message position within this block
+        const auto midiData = *midiIterator;
+        const auto midiMessagePosition = juce::jlimit(0, lastMidiSample, midiData.samplePosition - firstMidiSample) * midiScale;
 
         // render up to next midi message
         render(buffer, currentSample, midiMessagePosition - currentSample);
         currentSample = midiMessagePosition;
 
         // handle midi message
-        handleMidiEvent(midiMessage);
+        ScopedProfileStage profileStage(profiler, ProfileStage::MidiHandling);
+        handleMidiEvent(midiData.getMessage());
     }
 
     // render the rest of the block
@@ -233,20 +356,197 @@ void Synthesizer::processBlock(juce::AudioBuffer<float> &buffer, juce::MidiBuffe
 
 void Synthesizer::render(juce::AudioBuffer<float> &buffer, int startSample, int numSamples)
 { 
+    // empty when a midi event falls on the first sample of a segment
+    if (numSamples <= 0)
+        return;
+
+    TRACE_SCOPE("Synthesizer::render");
+    ScopedProfileStage profileStage(profiler, ProfileStage::VoiceRender);
+
     buffer.clear(startSample, numSamples);
-    for (auto &oscillator : this->oscillators)
+
+    const int renderedDetuneVoices = getRenderedDetuneVoices();
+
+    int numActiveVoices = 0;
+    for (int voiceIndex = 0; voiceIndex < MAX_POLYPHONY; voiceIndex++)
     {
-        oscillator.setDetuneVoices(detuneVoices);
+        auto &oscillator = oscillators[voiceIndex];
+        oscillator.setDetuneVoices(renderedDetuneVoices);
         oscillator.setDetuneSpread(detuneSpread);
         oscillator.setDetuneMix(detuneMix);
         oscillator.updateDetuneVoiceConfiguration();
+
+        // the rest of a release that can no longer be heard is not worth rendering
+        if (oscillator.isReleasedBelow(voiceSilenceThresholdGain))
+            oscillator.stopAdsrEnvelope();
+
         if (oscillator.adsrEnvelopeIsActive())
         {
-            oscillator.render(buffer, startSample, numSamples);
+            voiceRenderBatch.voiceIndices[numActiveVoices++] = voiceIndex;
+        }
+    }
+
+    const bool renderInParallel = workerPool != nullptr && multithreaded
+        && numActiveVoices >= PARALLEL_RENDER_MIN_VOICES
+        && numSamples >= PARALLEL_RENDER_MIN_SAMPLES;
+
+    // voices only go through their own buffers when something has to happen between
+    // rendering and mixing; otherwise they add straight into the output
+    const bool useVoiceBuffers = (renderInParallel || filterBank.isEnabled())
+        && startSample + numSamples <= voiceBufferSize;
+
+    if (!useVoiceBuffers)
+    {
+        for (int activeVoice = 0; activeVoice < numActiveVoices; activeVoice++)
+        {
+            auto &oscillator = oscillators[voiceRenderBatch.voiceIndices[activeVoice]];
+            oscillator.render(buffer, startSample, numSamples, getParameterRamps(startSample));
+        }
+        return;
+    }
+
+    if (filterBank.isEnabled())
+        updateFilterModulation(numActiveVoices);
+
+    renderVoicesToVoiceBuffers(startSample, numSamples, numActiveVoices, renderInParallel);
+
+    if (filterBank.isEnabled())
+    {
+        for (int activeVoice = 0; activeVoice < numActiveVoices; activeVoice++)
+        {
+            const int voiceIndex = voiceRenderBatch.voiceIndices[activeVoice];
+            filterModulation[voiceIndex].envelopeEnd = oscillators[voiceIndex].getEnvelopeLevel();
         }
+
+        filterBank.process(voiceBuffers, filterModulation, voiceRenderBatch.voiceIndices, numActiveVoices, startSample, numSamples);
+    }
+
+    // summed in voice order so the result does not depend on which thread rendered what
+    for (int activeVoice = 0; activeVoice < numActiveVoices; activeVoice++)
+    {
+        const auto &voiceBuffer = voiceBuffers[voiceRenderBatch.voiceIndices[activeVoice]];
+        for (int channel = 0; channel < voiceBuffer.getNumChannels(); channel++)
+            kernels->add(buffer.getWritePointer(channel, startSample), voiceBuffer.getReadPointer(channel, startSample), numSamples);
+    }
+}
+
+// in parallel this is one task per active voice; the calling thread renders too and
+// returns once all are done
+void Synthesizer::renderVoicesToVoiceBuffers(int startSample, int numSamples, int numActiveVoices, bool renderInParallel)
+{
+    voiceRenderBatch.startSample = startSample;
+    voiceRenderBatch.numSamples = numSamples;
+    voiceRenderBatch.ramps = getParameterRamps(startSample);
+
+    if (renderInParallel)
+    {
+        voiceTaskGroup.run(*workerPool, &Synthesizer::renderVoiceTask, &voiceRenderBatch, numActiveVoices);
+        return;
+    }
+
+    for (int activeVoice = 0; activeVoice < numActiveVoices; activeVoice++)
+    {
+        renderVoiceTask(&voiceRenderBatch, activeVoice);
+    }
+}
+
+// key tracking follows the note, the envelope is followed from where the last call left it
+void Synthesizer::updateFilterModulation(int numActiveVoices)
+{
+    for (int activeVoice = 0; activeVoice < numActiveVoices; activeVoice++)
+    {
+        const int voiceIndex = voiceRenderBatch.voiceIndices[activeVoice];
+        auto &modulation = filterModulation[voiceIndex];
+        modulation.noteNumber = (float) voices[voiceIndex].noteNumber;
+        modulation.envelopeStart = oscillators[voiceIndex].getEnvelopeLevel();
+    }
+}
+
+// may run on a pool worker; touches only its own oscillator and voice buffer
+void Synthesizer::renderVoiceTask(void *context, int taskIndex)
+{
+    auto &batch = *static_cast<VoiceRenderBatch *>(context);
+    const int voiceIndex = batch.voiceIndices[taskIndex];
+
+    auto &voiceBuffer = batch.synthesizer->voiceBuffers[voiceIndex];
+    voiceBuffer.clear(batch.startSample, batch.numSamples);
+    batch.synthesizer->oscillators[voiceIndex].render(voiceBuffer, batch.startSample, batch.numSamples, batch.ramps);
+}
+
+// render smoothed parameters for the whole block; settled parameters skip the ramp
+void Synthesizer::renderParameterRamps(int numSamples)
+{
+    volumeSmoother.renderBlock(numSamples);
+    panSmoother.renderBlock(numSamples);
+    detuneSpreadSmoother.renderBlock(numSamples);
+}
+
+ParameterRamps Synthesizer::getParameterRamps(int startSample) const
+{
+    ParameterRamps ramps;
+    ramps.volume = volumeSmoother.isRamping() ? volumeSmoother.getRampPointer(startSample) : nullptr;
+    ramps.pan = panSmoother.isRamping() ? panSmoother.getRampPointer(startSample) : nullptr;
+    ramps.detuneSpread = detuneSpreadSmoother.isRamping() ? detuneSpreadSmoother.getRampPointer(startSample) : nullptr;
+    return ramps;
+}
+
+//=============================================================================
+// RENDER STATE
+
+int Synthesizer::getNumActiveVoices() const
+{
+    int numActiveVoices = 0;
+    for (const auto &oscillator : oscillators)
+    {
+        if (oscillator.adsrEnvelopeIsActive())
+            numActiveVoices++;
+    }
+    return numActiveVoices;
+}
+
+// unison voices rendered per active note
+int Synthesizer::getNumUnisonLanes() const
+{
+    return juce::jmax(1, getRenderedDetuneVoices());
+}
+
+// audio thread only; copies the state the editor displays
+void Synthesizer::fillRenderState(RenderState &renderState) const
+{
+    renderState.wavetableFrameIndex = wavetableFrameIndex;
+    renderState.numWavetableFrames = wavetableNumFrames;
+    renderState.numActiveVoices = getNumActiveVoices();
+
+    for (int voiceIndex = 0; voiceIndex < MAX_POLYPHONY; voiceIndex++)
+    {
+        renderState.envelopeLevels[voiceIndex] = oscillators[voiceIndex].getEnvelopeLevel();
     }
 }
 
+// without a seed the phases come from a time-seeded generator, as in the plugin
+void Synthesizer::setRandomSeed(juce::int64 newSeed)
+{
+    randomSeed = newSeed;
+    hasRandomSeed = true;
+    phaseRandom.setSeed(randomSeed);
+}
+
+// stage timings go to this profiler while it is active; nullptr disables them
+void Synthesizer::setProfiler(BlockProfiler *profilerToUse)
+{
+    profiler = profilerToUse;
+}
+
+void Synthesizer::setWorkerPool(WorkerPool *poolToUse)
+{
+    workerPool = poolToUse;
+}
+
+void Synthesizer::setMultithreaded(bool shouldRenderInParallel)
+{
+    multithreaded = shouldRenderInParallel;
+}
+
 //=============================================================================
 // MIDI
 
@@ -270,6 +570,7 @@ void Synthesizer::handleMidiEvent(const juce::MidiMessage &midiMessage)
 
 void Synthesizer::startNote(int midiNoteNumber, float velocity)
 {
+    TRACE_SCOPE("Synthesizer::startNote");
     auto voiceIndex = findVoice(midiNoteNumber);
     if (voiceIndex < 0 || voiceIndex > MAX_POLYPHONY)
     {
@@ -279,13 +580,18 @@ void Synthesizer::startNote(int midiNoteNumber, float velocity)
 
     updateVoiceAges();
     auto &voice = voices[voiceIndex];
+    auto &oscillator = oscillators[voiceIndex];
+
+    // a retriggered note keeps its filter state, a new or stolen voice starts clean
+    if (!oscillator.adsrEnvelopeIsActive() || voice.noteNumber != midiNoteNumber)
+        filterBank.resetVoice(voiceIndex);
+
     voice.noteNumber = midiNoteNumber;
     voice.age = 0;
 
-    auto &oscillator = oscillators[voiceIndex];
     oscillator.setFrequency(calculateFrequencyFromOffsetMidiNote(midiNoteNumber, getPitchBendOffsetCents()));
     oscillator.setVelocity(velocity);
-    oscillator.randomizePhases();
+    oscillator.randomizePhases(phaseRandom);
     oscillator.startAdsrEnvelope();
 }
 
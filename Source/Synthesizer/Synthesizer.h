@@ -3,8 +3,26 @@
 
 #include <JuceHeader.h>
 #include "Oscillator.h"
+#include "SmoothedParameter.h"
+#include "VoiceFilterBank.h"
+#include "../Utilities/BlockProfiler.h"
+#include "../Utilities/TraceRecorder.h"
+#include "../Utilities/WorkerPool.h"
 
 #define MAX_POLYPHONY 16
+#define PARAMETER_SMOOTHING_SECONDS 0.02f
+
+// released voices quieter than this are retired instead of rendered to the end of their release
+#define DEFAULT_VOICE_SILENCE_THRESHOLD_DB -96.f
+#define MIN_VOICE_SILENCE_THRESHOLD_DB -140.f
+
+static_assert(MAX_FILTER_VOICES >= MAX_POLYPHONY, "every voice needs a filter");
+
+// below these the hand-off to the pool costs more than it saves
+#define PARALLEL_RENDER_MIN_VOICES 2
+#define PARALLEL_RENDER_MIN_SAMPLES 32
+
+struct RenderState;
 
 class Synthesizer
 {
@@ -15,13 +33,36 @@ public:
 	~Synthesizer() {};
 
 	//==============================================================================
+	// numOutputChannels is 1 or 2; processBlock must then be handed that many channels
+	void prepare(int maximumBlockSize, int numOutputChannels = 2);
 	void processBlock(juce::AudioBuffer<float> &buffer, juce::MidiBuffer &midiBuffer);
+
+	// midi read in place from part of a larger buffer: each event lands on sample
+	// (samplePosition - firstMidiSample) * midiScale, clamped into the block first
+	void processBlock(juce::AudioBuffer<float> &buffer, juce::MidiBufferIterator midiBegin, juce::MidiBufferIterator midiEnd,
+	                  int firstMidiSample = 0, int midiScale = 1);
 	
 	void setWavetable(Wavetable &);
+	void setWavetable(std::shared_ptr<const Wavetable>);
 	void setWavetableFrameIndex(int);
 	const Wavetable *getWavetableReadPointer() const;
 	int getNumWavetableFrames() const;
 
+	int getNumActiveVoices() const;
+	int getNumUnisonLanes() const;
+	void fillRenderState(RenderState &) const;
+
+	void setProfiler(BlockProfiler *);
+
+	// active voices render in parallel on this pool; set before prepare(), nullptr renders serially
+	void setWorkerPool(WorkerPool *);
+
+	// with a pool set, whether blocks may use it; takes effect at the next block
+	void setMultithreaded(bool);
+
+	// deterministic rendering: every prepare() restarts unison phases from this seed
+	void setRandomSeed(juce::int64);
+
 	float getSampleRate() const;
 	void setSampleRate(float);
 
@@ -38,9 +79,19 @@ public:
 	void setDetuneMix(float);
 	void setDetuneSpread(float);
 
+	// caps the unison voices actually rendered, whatever setDetuneVoices asks for
+	void setUnisonVoiceLimit(int);
+
+	// one of InterpolationModes
+	void setInterpolationMode(int);
+
+	void setFilterParameters(int mode, float cutoffHz, float resonance, float envelopeAmount, float keyTracking);
+
+	void setVoiceSilenceThreshold(float decibels);
+
 private:
 	//==============================================================================
-	Wavetable wavetable;
+	std::shared_ptr<const Wavetable> wavetable;
 	int wavetableSize;
 	int wavetableNumFrames;
 	int wavetableFrameIndex;
@@ -56,9 +107,50 @@ private:
 	float pan;
 	
 	int detuneVoices;
+	int unisonVoiceLimit;
 	float detuneMix;
 	float detuneSpread;
 
+	int interpolationMode;
+
+	float voiceSilenceThresholdGain;
+
+	// host automation of these is ramped across each block to avoid zipper noise
+	SmoothedParameter volumeSmoother;
+	SmoothedParameter panSmoother;
+	SmoothedParameter detuneSpreadSmoother;
+
+	BlockProfiler *profiler;
+
+	// voice mixing, for the instruction set chosen at startup
+	const DspKernels *kernels;
+
+	// per-voice filters, run across voices after rendering and before mixing
+	VoiceFilterBank filterBank;
+	FilterVoiceModulation filterModulation[MAX_POLYPHONY];
+
+	// parallel voice rendering: each voice renders into its own buffer, which
+	// are then summed in voice order so the result does not depend on scheduling
+	WorkerPool *workerPool;
+	bool multithreaded;
+	WorkerTaskGroup voiceTaskGroup;
+	juce::AudioBuffer<float> voiceBuffers[MAX_POLYPHONY];
+	int voiceBufferSize;
+
+	struct VoiceRenderBatch
+	{
+		Synthesizer *synthesizer;
+		int voiceIndices[MAX_POLYPHONY];
+		int startSample;
+		int numSamples;
+		ParameterRamps ramps;
+	} voiceRenderBatch;
+
+	// unison phases drawn on note-on
+	juce::Random phaseRandom;
+	juce::int64 randomSeed;
+	bool hasRandomSeed;
+
 	//==============================================================================
 	struct Voice
 	{
@@ -74,10 +166,16 @@ private:
 
 	//==============================================================================
 	void render(juce::AudioBuffer<float> &buffer, int startSample, int endSample);
+	void renderVoicesToVoiceBuffers(int startSample, int numSamples, int numActiveVoices, bool renderInParallel);
+	void updateFilterModulation(int numActiveVoices);
+	static void renderVoiceTask(void *context, int taskIndex);
+	void renderParameterRamps(int numSamples);
+	ParameterRamps getParameterRamps(int startSample) const;
 
 	void updateOscillators();
 	void updateOscillator(Oscillator &);
 	void updateOscillatorDetuneParameters(Oscillator &);
+	int getRenderedDetuneVoices() const;
 
 	float calculateFrequencyFromMidiInput(int midiNoteNuber, float pitchWheelPosition) const;
 	float calculateFrequencyFromOffsetMidiNote(int midiNoteNumber, float centsOffset) const;
@@ -1,21 +1,117 @@
 #include "SynthesizerState.h"
+#include "Synthesizer.h"
 
-//SynthesizerState getSynthesizerStateFromValueTree(juce::AudioProcessorValueTreeState& valueTree);
-
+#if JUCE_MODULE_AVAILABLE_juce_audio_processors
 SynthesizerState getSynthesizerStateFromValueTree(juce::AudioProcessorValueTreeState& valueTree)
 {
     SynthesizerState state;
 
+    state.octaveTranspose = (int) valueTree.getRawParameterValue("OCTAVE_TRANSPOSE")->load();
+    state.semitoneTranspose = (int) valueTree.getRawParameterValue("SEMITONE_TRANSPOSE")->load();
+    state.fineTranspose = (int) valueTree.getRawParameterValue("FINE_TRANSPOSE")->load();
+    state.coarseTranspose = valueTree.getRawParameterValue("COARSE_TRANSPOSE")->load();
+
+    state.adsrAttack = valueTree.getRawParameterValue("ADSR_ATTACK")->load();
+    state.adsrDecay = valueTree.getRawParameterValue("ADSR_DECAY")->load();
+    state.adsrSustain = valueTree.getRawParameterValue("ADSR_SUSTAIN")->load();
+    state.adsrRelease = valueTree.getRawParameterValue("ADSR_RELEASE")->load();
+
     state.oscVolume = valueTree.getRawParameterValue("OSC_VOLUME")->load();
     state.oscPanning = valueTree.getRawParameterValue("OSC_PANNING")->load();
 
+    state.oscDetuneVoices = (int) valueTree.getRawParameterValue("OSC_DETUNE_VOICES")->load();
+    state.oscDetuneSpread = valueTree.getRawParameterValue("OSC_DETUNE_SPREAD")->load();
     state.oscDetuneMix = valueTree.getRawParameterValue("OSC_DETUNE_MIX")->load();
+
     state.oscWarpAmount = valueTree.getRawParameterValue("OSC_WARP_AMOUNT")->load();
+    state.oscWarpMode = (int) valueTree.getRawParameterValue("OSC_WARP_MODE")->load();
 
     state.oscWavetablePosition = valueTree.getRawParameterValue("OSC_WAVETABLE_POSITION")->load();
     state.oscWavetableNumFrames = (int) valueTree.getRawParameterValue("OSC_WAVETABLE_NUM_FRAMES")->load();
     state.oscWavetableCurrentFrame = (int) valueTree.getRawParameterValue("OSC_WAVETABLE_CURRENT_FRAME")->load();
 
+    state.filterMode = (int) valueTree.getRawParameterValue("FILTER_MODE")->load();
+    state.filterCutoff = valueTree.getRawParameterValue("FILTER_CUTOFF")->load();
+    state.filterResonance = valueTree.getRawParameterValue("FILTER_RESONANCE")->load();
+    state.filterEnvelopeAmount = valueTree.getRawParameterValue("FILTER_ENVELOPE_AMOUNT")->load();
+    state.filterKeyTracking = valueTree.getRawParameterValue("FILTER_KEY_TRACKING")->load();
+
+    state.voiceSilenceThreshold = valueTree.getRawParameterValue("VOICE_SILENCE_THRESHOLD")->load();
 
     return state;
 }
+#endif
+
+// parameters are stored as PARAM children holding an id and a value property
+static float getParameterValue(const juce::ValueTree& parameterTree, const juce::String& parameterId, float defaultValue)
+{
+    auto parameter = parameterTree.getChildWithProperty("id", parameterId);
+    return parameter.isValid() ? (float) parameter.getProperty("value", defaultValue) : defaultValue;
+}
+
+SynthesizerState getSynthesizerStateFromParameterTree(const juce::ValueTree& parameterTree)
+{
+    SynthesizerState state;
+
+    state.octaveTranspose = (int) getParameterValue(parameterTree, "OCTAVE_TRANSPOSE", (float) state.octaveTranspose);
+    state.semitoneTranspose = (int) getParameterValue(parameterTree, "SEMITONE_TRANSPOSE", (float) state.semitoneTranspose);
+    state.fineTranspose = (int) getParameterValue(parameterTree, "FINE_TRANSPOSE", (float) state.fineTranspose);
+    state.coarseTranspose = getParameterValue(parameterTree, "COARSE_TRANSPOSE", state.coarseTranspose);
+
+    state.adsrAttack = getParameterValue(parameterTree, "ADSR_ATTACK", state.adsrAttack);
+    state.adsrDecay = getParameterValue(parameterTree, "ADSR_DECAY", state.adsrDecay);
+    state.adsrSustain = getParameterValue(parameterTree, "ADSR_SUSTAIN", state.adsrSustain);
+    state.adsrRelease = getParameterValue(parameterTree, "ADSR_RELEASE", state.adsrRelease);
+
+    state.oscVolume = getParameterValue(parameterTree, "OSC_VOLUME", state.oscVolume);
+    state.oscPanning = getParameterValue(parameterTree, "OSC_PANNING", state.oscPanning);
+
+    state.oscDetuneVoices = (int) getParameterValue(parameterTree, "OSC_DETUNE_VOICES", (float) state.oscDetuneVoices);
+    state.oscDetuneSpread = getParameterValue(parameterTree, "OSC_DETUNE_SPREAD", state.oscDetuneSpread);
+    state.oscDetuneMix = getParameterValue(parameterTree, "OSC_DETUNE_MIX", state.oscDetuneMix);
+
+    state.oscWarpAmount = getParameterValue(parameterTree, "OSC_WARP_AMOUNT", state.oscWarpAmount);
+    state.oscWarpMode = (int) getParameterValue(parameterTree, "OSC_WARP_MODE", (float) state.oscWarpMode);
+
+    state.oscWavetablePosition = getParameterValue(parameterTree, "OSC_WAVETABLE_POSITION", state.oscWavetablePosition);
+    state.oscWavetableNumFrames = (int) getParameterValue(parameterTree, "OSC_WAVETABLE_NUM_FRAMES", (float) state.oscWavetableNumFrames);
+    state.oscWavetableCurrentFrame = (int) getParameterValue(parameterTree, "OSC_WAVETABLE_CURRENT_FRAME", (float) state.oscWavetableCurrentFrame);
+
+    state.filterMode = (int) getParameterValue(parameterTree, "FILTER_MODE", (float) state.filterMode);
+    state.filterCutoff = getParameterValue(parameterTree, "FILTER_CUTOFF", state.filterCutoff);
+    state.filterResonance = getParameterValue(parameterTree, "FILTER_RESONANCE", state.filterResonance);
+    state.filterEnvelopeAmount = getParameterValue(parameterTree, "FILTER_ENVELOPE_AMOUNT", state.filterEnvelopeAmount);
+    state.filterKeyTracking = getParameterValue(parameterTree, "FILTER_KEY_TRACKING", state.filterKeyTracking);
+
+    state.voiceSilenceThreshold = getParameterValue(parameterTree, "VOICE_SILENCE_THRESHOLD", state.voiceSilenceThreshold);
+
+    return state;
+}
+
+void applySynthesizerState(Synthesizer& synthesizer, const SynthesizerState& state)
+{
+    // set transposition parameters
+    synthesizer.setTransposeValues(state.octaveTranspose, state.semitoneTranspose, state.fineTranspose, state.coarseTranspose);
+
+    // set adsr parameters
+    synthesizer.setAdsrParameters(state.adsrAttack, state.adsrDecay, state.adsrSustain, state.adsrRelease);
+
+    // set mixing parameters
+    synthesizer.setVolume(state.oscVolume);
+    synthesizer.setPan(state.oscPanning);
+
+    // set detune parameters
+    synthesizer.setDetuneVoices(state.oscDetuneVoices);
+    synthesizer.setDetuneSpread(state.oscDetuneSpread);
+    synthesizer.setDetuneMix(state.oscDetuneMix);
+
+    // set wavetable parameters
+    int wavetablePosition = (int) std::floor(state.oscWavetablePosition * (std::max(0, synthesizer.getNumWavetableFrames() - 1)));
+    synthesizer.setWavetableFrameIndex(wavetablePosition);
+
+    // set filter parameters
+    synthesizer.setFilterParameters(state.filterMode, state.filterCutoff, state.filterResonance, state.filterEnvelopeAmount, state.filterKeyTracking);
+
+    // set voice parameters
+    synthesizer.setVoiceSilenceThreshold(state.voiceSilenceThreshold);
+}
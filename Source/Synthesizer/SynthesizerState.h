@@ -3,24 +3,68 @@
 
 #include <JuceHeader.h>
 
-// contains parameters for peak, low cut, and high cut filters
+class Synthesizer;
+
+// one snapshot of every synthesizer parameter; the member defaults are the
+// defaults of the plugin's parameter layout
 struct SynthesizerState
 {
+    //========================================================================
+    // TRANSPOSE
+
+    int   octaveTranspose{ 0 };
+    int   semitoneTranspose{ 0 };
+    int   fineTranspose{ 0 };
+    float coarseTranspose{ 0.f };
+
+    //========================================================================
+    // ADSR
+
+    float adsrAttack{ 0.0005f };
+    float adsrDecay{ 1.f };
+    float adsrSustain{ 1.f };
+    float adsrRelease{ 0.015f };
+
     //========================================================================
     // OSC
 
     // Mixing Parameters
-    float oscVolume{ 0.f };
+    float oscVolume{ 0.75f };
     float oscPanning{ 0.f };
 
-    float oscDetuneMix{0.f};
-    float oscWarpAmount{0.f};
+    int   oscDetuneVoices{ 1 };
+    float oscDetuneSpread{ 0.5f };
+    float oscDetuneMix{ 0.f };
+
+    float oscWarpAmount{ 0.f };
+    int   oscWarpMode{ 0 };
 
-    float oscWavetablePosition{0.f};
-    int   oscWavetableNumFrames{0};
-    int   oscWavetableCurrentFrame{0};
+    float oscWavetablePosition{ 0.f };
+    int   oscWavetableNumFrames{ 0 };
+    int   oscWavetableCurrentFrame{ 0 };
+
+    //========================================================================
+    // FILTER
+
+    int   filterMode{ 0 };
+    float filterCutoff{ 20000.f };
+    float filterResonance{ 0.f };
+    float filterEnvelopeAmount{ 0.f };
+    float filterKeyTracking{ 0.f };
+
+    //========================================================================
+    // VOICES
+
+    float voiceSilenceThreshold{ -96.f };
 };
 
+#if JUCE_MODULE_AVAILABLE_juce_audio_processors
 SynthesizerState getSynthesizerStateFromValueTree(juce::AudioProcessorValueTreeState& valueTree);
+#endif
+
+// reads the tree written by getStateInformation; missing parameters keep their defaults
+SynthesizerState getSynthesizerStateFromParameterTree(const juce::ValueTree& parameterTree);
+
+void applySynthesizerState(Synthesizer& synthesizer, const SynthesizerState& state);
 
 #endif // SYNTHESIZER_STATE_H
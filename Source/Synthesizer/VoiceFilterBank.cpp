@@ -0,0 +1,225 @@
+#include "VoiceFilterBank.h"
+
+//=============================================================================
+// CONSTRUCTORS / DESTRUCTORS
+
+VoiceFilterBank::VoiceFilterBank()
+{
+    sampleRate = 48000.f;
+
+    mode = FilterOff;
+    cutoffHz = 20000.f;
+    resonance = 0.f;
+    envelopeAmount = 0.f;
+    keyTracking = 0.f;
+
+    for (int voice = 0; voice < numPaddedVoices; ++voice)
+    {
+        coefficientA1[voice] = 1.f;
+        coefficientA2[voice] = 0.f;
+        coefficientA3[voice] = 0.f;
+        dampingK[voice] = 2.f;
+        voiceIsActive[voice] = false;
+    }
+
+    reset();
+}
+
+//=============================================================================
+// PARAMETERS
+
+void VoiceFilterBank::setSampleRate(float newSampleRate)
+{
+    sampleRate = juce::jmax(1.f, newSampleRate);
+}
+
+// cutoff [20, 20k] Hz, resonance [0, 1], envelope amount [-1, 1], key tracking [0, 1]
+void VoiceFilterBank::setParameters(int newMode, float newCutoffHz, float newResonance, float newEnvelopeAmount, float newKeyTracking)
+{
+    newMode = juce::jlimit((int) FilterOff, NumFilterModes - 1, newMode);
+
+    // a filter switched back on must not ring out whatever it held when it was switched off
+    if (mode == FilterOff && newMode != FilterOff)
+        reset();
+
+    mode = newMode;
+    cutoffHz = juce::jlimit(20.f, 20000.f, newCutoffHz);
+    resonance = juce::jlimit(0.f, 1.f, newResonance);
+    envelopeAmount = juce::jlimit(-1.f, 1.f, newEnvelopeAmount);
+    keyTracking = juce::jlimit(0.f, 1.f, newKeyTracking);
+}
+
+bool VoiceFilterBank::isEnabled() const
+{
+    return mode != FilterOff;
+}
+
+void VoiceFilterBank::reset()
+{
+    for (int voice = 0; voice < numPaddedVoices; ++voice)
+    {
+        resetVoice(voice);
+    }
+}
+
+void VoiceFilterBank::resetVoice(int voiceIndex)
+{
+    jassert(voiceIndex >= 0 && voiceIndex < numPaddedVoices);
+
+    for (int channel = 0; channel < 2; ++channel)
+    {
+        integratorState1[channel][voiceIndex] = 0.f;
+        integratorState2[channel][voiceIndex] = 0.f;
+    }
+}
+
+//=============================================================================
+// COEFFICIENTS
+
+// control rate, scalar per voice; the tangent comes from a pade approximant, which is
+// accurate to well below audibility over the clamped range
+void VoiceFilterBank::updateCoefficients(const FilterVoiceModulation *modulation, const int *voiceIndices, int numActiveVoices, float envelopePosition)
+{
+    const float maximumCutoffHz = 0.45f * sampleRate;
+    const float damping = 2.f - 1.96f * resonance;
+
+    for (int activeVoice = 0; activeVoice < numActiveVoices; ++activeVoice)
+    {
+        const int voice = voiceIndices[activeVoice];
+        const auto &voiceModulation = modulation[voice];
+
+        const float envelope = voiceModulation.envelopeStart + envelopePosition * (voiceModulation.envelopeEnd - voiceModulation.envelopeStart);
+        const float octaves = keyTracking * (voiceModulation.noteNumber - FILTER_KEY_TRACKING_CENTRE_NOTE) / 12.f
+                            + envelopeAmount * FILTER_ENVELOPE_OCTAVES * envelope;
+
+        const float cutoff = juce::jlimit(20.f, maximumCutoffHz, cutoffHz * std::exp2(octaves));
+        const float g = juce::dsp::FastMathApproximations::tan(juce::MathConstants<float>::pi * cutoff / sampleRate);
+
+        coefficientA1[voice] = 1.f / (1.f + g * (g + damping));
+        coefficientA2[voice] = g * coefficientA1[voice];
+        coefficientA3[voice] = g * coefficientA2[voice];
+        dampingK[voice] = damping;
+    }
+}
+
+//=============================================================================
+// PROCESSING
+
+void VoiceFilterBank::process(juce::AudioBuffer<float> *voiceBuffers, const FilterVoiceModulation *modulation, const int *voiceIndices,
+                              int numActiveVoices, int startSample, int numSamples)
+{
+    if (mode == FilterOff || numActiveVoices <= 0 || numSamples <= 0)
+        return;
+
+    bool groupIsActive[numGroups] = {};
+    std::fill(voiceIsActive, voiceIsActive + numPaddedVoices, false);
+    for (int activeVoice = 0; activeVoice < numActiveVoices; ++activeVoice)
+    {
+        voiceIsActive[voiceIndices[activeVoice]] = true;
+        groupIsActive[voiceIndices[activeVoice] / numLanes] = true;
+    }
+
+    const int numChannels = juce::jmin(2, voiceBuffers[voiceIndices[0]].getNumChannels());
+
+    for (int intervalStart = 0; intervalStart < numSamples; intervalStart += FILTER_CONTROL_INTERVAL)
+    {
+        const int intervalLength = juce::jmin(FILTER_CONTROL_INTERVAL, numSamples - intervalStart);
+
+        // the envelope is followed at the middle of each interval
+        const float envelopePosition = ((float) intervalStart + 0.5f * (float) intervalLength) / (float) numSamples;
+        updateCoefficients(modulation, voiceIndices, numActiveVoices, envelopePosition);
+
+        for (int group = 0; group < numGroups; ++group)
+        {
+            if (groupIsActive[group])
+                processGroup(group, voiceBuffers, numChannels, startSample + intervalStart, intervalLength);
+        }
+    }
+}
+
+// gathers one channel of every voice in the group into lanes, filters, and scatters back
+void VoiceFilterBank::processGroup(int group, juce::AudioBuffer<float> *voiceBuffers, int numChannels, int startSample, int numSamples)
+{
+    const int firstVoice = group * numLanes;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            const int voice = firstVoice + lane;
+            if (voiceIsActive[voice])
+            {
+                const auto *input = voiceBuffers[voice].getReadPointer(channel, startSample);
+                for (int sample = 0; sample < numSamples; ++sample)
+                    laneBuffer[sample * numLanes + lane] = input[sample];
+            }
+            else
+            {
+                for (int sample = 0; sample < numSamples; ++sample)
+                    laneBuffer[sample * numLanes + lane] = 0.f;
+            }
+        }
+
+        auto state1 = SimdFloat::fromRawArray(integratorState1[channel] + firstVoice);
+        auto state2 = SimdFloat::fromRawArray(integratorState2[channel] + firstVoice);
+
+        switch (mode)
+        {
+            case FilterLowPass:  processLanes<FilterLowPass>(group, numSamples, state1, state2);  break;
+            case FilterHighPass: processLanes<FilterHighPass>(group, numSamples, state1, state2); break;
+            case FilterBandPass: processLanes<FilterBandPass>(group, numSamples, state1, state2); break;
+            case FilterNotch:    processLanes<FilterNotch>(group, numSamples, state1, state2);    break;
+            default: break;
+        }
+
+        state1.copyToRawArray(integratorState1[channel] + firstVoice);
+        state2.copyToRawArray(integratorState2[channel] + firstVoice);
+
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            const int voice = firstVoice + lane;
+            if (!voiceIsActive[voice])
+                continue;
+
+            auto *output = voiceBuffers[voice].getWritePointer(channel, startSample);
+            for (int sample = 0; sample < numSamples; ++sample)
+                output[sample] = laneBuffer[sample * numLanes + lane];
+        }
+    }
+}
+
+// andrew simper's trapezoidal svf, one voice per lane
+template <int filterMode>
+void VoiceFilterBank::processLanes(int group, int numSamples, SimdFloat &state1, SimdFloat &state2)
+{
+    const int firstVoice = group * numLanes;
+    const auto a1 = SimdFloat::fromRawArray(coefficientA1 + firstVoice);
+    const auto a2 = SimdFloat::fromRawArray(coefficientA2 + firstVoice);
+    const auto a3 = SimdFloat::fromRawArray(coefficientA3 + firstVoice);
+    const auto k = SimdFloat::fromRawArray(dampingK + firstVoice);
+
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        auto *lanes = laneBuffer + sample * numLanes;
+        const auto v0 = SimdFloat::fromRawArray(lanes);
+
+        const auto v3 = v0 - state2;
+        const auto v1 = a1 * state1 + a2 * v3;
+        const auto v2 = state2 + a2 * state1 + a3 * v3;
+
+        state1 = v1 * 2.f - state1;
+        state2 = v2 * 2.f - state2;
+
+        SimdFloat output;
+        if (filterMode == FilterLowPass)
+            output = v2;
+        else if (filterMode == FilterBandPass)
+            output = v1;
+        else if (filterMode == FilterHighPass)
+            output = v0 - k * v1 - v2;
+        else
+            output = v0 - k * v1;
+
+        output.copyToRawArray(lanes);
+    }
+}
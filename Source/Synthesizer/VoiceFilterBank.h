@@ -0,0 +1,98 @@
+#ifndef VOICE_FILTER_BANK_H
+#define VOICE_FILTER_BANK_H
+
+#include <JuceHeader.h>
+
+#define MAX_FILTER_VOICES 16
+
+// coefficients are recomputed every this many samples
+#define FILTER_CONTROL_INTERVAL 32
+
+// full envelope amount sweeps the cutoff this far
+#define FILTER_ENVELOPE_OCTAVES 6.f
+
+// key tracking is relative to middle c
+#define FILTER_KEY_TRACKING_CENTRE_NOTE 60.f
+
+enum FilterModes {
+	FilterOff = 0,
+	FilterLowPass,
+	FilterHighPass,
+	FilterBandPass,
+	FilterNotch,
+	NumFilterModes
+};
+
+// modulation sources of one voice over one render call
+struct FilterVoiceModulation
+{
+	float noteNumber{ FILTER_KEY_TRACKING_CENTRE_NOTE };
+	float envelopeStart{ 0.f };
+	float envelopeEnd{ 0.f };
+};
+
+// one stereo trapezoidal state-variable filter per voice. state and coefficients are
+// stored structure-of-arrays by voice so each SIMD instruction advances a whole group
+// of voices by one sample; groups without an active voice are skipped
+class VoiceFilterBank
+{
+public:
+
+	//=============================================================================
+	VoiceFilterBank();
+
+	void setSampleRate(float);
+	void setParameters(int mode, float cutoffHz, float resonance, float envelopeAmount, float keyTracking);
+
+	bool isEnabled() const;
+
+	void reset();
+	void resetVoice(int voiceIndex);
+
+	//=============================================================================
+	// filters voiceBuffers[voiceIndices[i]] in place over [startSample, startSample + numSamples);
+	// voiceBuffers and modulation are indexed by voice, and every voice buffer has the same
+	// one or two channels
+	void process(juce::AudioBuffer<float> *voiceBuffers, const FilterVoiceModulation *modulation, const int *voiceIndices,
+	             int numActiveVoices, int startSample, int numSamples);
+
+private:
+	//=============================================================================
+	using SimdFloat = juce::dsp::SIMDRegister<float>;
+	static constexpr int numLanes = (int) SimdFloat::SIMDNumElements;
+	static constexpr int numGroups = (MAX_FILTER_VOICES + numLanes - 1) / numLanes;
+	static constexpr int numPaddedVoices = numGroups * numLanes;
+
+	//=============================================================================
+	float sampleRate;
+
+	int mode;
+	float cutoffHz;
+	float resonance;
+	float envelopeAmount;
+	float keyTracking;
+
+	//=============================================================================
+	// STATE AND COEFFICIENTS, [voice] or [channel][voice]
+	alignas(16) float integratorState1[2][numPaddedVoices];
+	alignas(16) float integratorState2[2][numPaddedVoices];
+
+	alignas(16) float coefficientA1[numPaddedVoices];
+	alignas(16) float coefficientA2[numPaddedVoices];
+	alignas(16) float coefficientA3[numPaddedVoices];
+	alignas(16) float dampingK[numPaddedVoices];
+
+	// lanes of the block being processed, sample-major
+	alignas(16) float laneBuffer[FILTER_CONTROL_INTERVAL * numLanes];
+
+	bool voiceIsActive[numPaddedVoices];
+
+	//=============================================================================
+	void updateCoefficients(const FilterVoiceModulation *modulation, const int *voiceIndices, int numActiveVoices, float envelopePosition);
+	void processGroup(int group, juce::AudioBuffer<float> *voiceBuffers, int numChannels, int startSample, int numSamples);
+
+	template <int filterMode>
+	void processLanes(int group, int numSamples, SimdFloat &state1, SimdFloat &state2);
+};
+
+#endif // VOICE_FILTER_BANK_H
@@ -0,0 +1,161 @@
+#include "WavetableGenerators.h"
+
+void generateSineWavetable(Wavetable& tableToFill, int resolution)
+{
+    tableToFill.setSize(1, resolution);
+    auto* samples = tableToFill.getWritePointer(0);
+
+    auto angleDelta = juce::MathConstants<float>::twoPi / (float)(resolution - 1);
+    auto currentAngle = 0.0;
+
+    for (int i = 0; i < resolution; ++i)
+    {
+        auto sample = std::sin(currentAngle);
+        samples[i] = (float)sample;
+        currentAngle += angleDelta;
+    }
+}
+
+void generateSineFrames(Wavetable &tableToFill, int resolution)
+{
+    tableToFill.setSize(3, resolution);
+
+    auto *samples = tableToFill.getWritePointer(0);
+    auto angleDelta = juce::MathConstants<float>::twoPi / (float)(resolution - 1);
+    auto currentAngle = 0.f;
+
+    for (int i = 0; i < resolution; ++i)
+    {
+        auto sample = std::sin(currentAngle);
+        samples[i] = (float)sample;
+        currentAngle += angleDelta;
+    }
+
+    samples = tableToFill.getWritePointer(1);
+    angleDelta *= 2.f;
+    currentAngle = 0.f;
+
+    for (int i = 0; i < resolution; ++i)
+    {
+        auto sample = std::sin(currentAngle);
+        samples[i] = (float)sample;
+        currentAngle += angleDelta;
+    }
+
+    samples = tableToFill.getWritePointer(2);
+    angleDelta *= 2.f;
+    currentAngle = 0.0;
+
+    for (int i = 0; i < resolution; ++i)
+    {
+        auto sample = std::sin(currentAngle);
+        samples[i] = (float)sample;
+        currentAngle += angleDelta;
+    }
+}
+
+void generateManySineFrames(Wavetable &tableToFill)
+{
+    int numFrames = 255;
+    int numSamples = 1024;
+    
+    tableToFill.setSize(numFrames, numSamples);
+
+    auto angleDelta = juce::MathConstants<float>::twoPi / (float)(numSamples - 1);
+
+    for (int frame = 0; frame < numFrames; frame++)
+    {
+        auto currentAngle = 0.f;
+        auto *samples = tableToFill.getWritePointer(frame);
+        for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
+        {
+            auto sampleValue = std::sin(currentAngle);
+            samples[sampleIndex] = (float) sampleValue;
+            currentAngle += angleDelta;
+        }
+        angleDelta *= 1.005f;
+    }
+}
+
+void generateRandomSineCombinations(Wavetable &tableToFill)
+{
+    int numFrames = 10;
+    int numSamples = 1024;
+
+    tableToFill.setSize(numFrames, numSamples);
+
+    auto angleDelta = juce::MathConstants<float>::twoPi / (float)(numSamples - 1);
+
+    juce::Random rng;
+    for (int frame = 0; frame < numFrames; frame++)
+    {
+        auto currentAngle = 0.f;
+        auto secondAngle = 0.f;
+        auto randomDelta = angleDelta * std::floor(1 + (rng.nextFloat() * 6));
+        //auto randomDelta = angleDelta * rng.nextFloat() * 10;
+        auto *samples = tableToFill.getWritePointer(frame);
+        for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
+        {
+            auto sampleValue = std::sin(currentAngle) * std::cos(secondAngle);
+            samples[sampleIndex] = (float)sampleValue;
+            currentAngle += angleDelta;
+            secondAngle += randomDelta;
+        }
+    }
+}
+
+void generateSquareWavetable(Wavetable& tableToFill, int resolution)
+{
+    tableToFill.setSize(1, resolution);
+    auto* samples = tableToFill.getWritePointer(0);
+
+    for (int i = 0; i < resolution; i++)
+    {
+        samples[i] = (i >= (resolution / 2)) ? -1.f : 1.f;
+    }
+}
+
+void generateSawWavetable(Wavetable& tableToFill, int resolution)
+{
+    tableToFill.setSize(1, resolution);
+    auto* samples = tableToFill.getWritePointer(0);
+
+    for (int i = 0; i < resolution/2; i++)
+    {
+        samples[i] = 0.f + (2.f * (float)i / (float)resolution);
+    }
+    for (int i = resolution / 2; i < resolution; i++)
+    {
+        samples[i] = -2.f + (2.f * (float)i / (float)resolution);
+    }
+}
+
+void generateMultiSineWavetable(Wavetable& tableToFill, int resolution, int coefficientA, int coefficientB)
+{
+    tableToFill.setSize(1, resolution);
+    auto* samples = tableToFill.getWritePointer(0);
+
+    auto angleDelta = juce::MathConstants<float>::twoPi / (float)(resolution - 1);
+    auto currentAngle = 0.0;
+
+    for (int i = 0; i < resolution; ++i)
+    {
+        auto sample = std::sin(currentAngle);
+        samples[i] = (float)sample;
+        currentAngle += angleDelta;
+    }
+
+    for (int i = 0; i < resolution; ++i)
+    {
+        auto sample = std::sin(currentAngle);
+        samples[i] *= (float)sample;
+        currentAngle += coefficientA * angleDelta;
+    }
+
+    for (int i = 0; i < resolution; ++i)
+    {
+        auto sample = std::sin(currentAngle);
+        samples[i] *= (float)sample;
+        currentAngle += coefficientB * angleDelta;
+    }
+}
@@ -0,0 +1,15 @@
+#ifndef WAVETABLE_GENERATORS_H
+#define WAVETABLE_GENERATORS_H
+
+#include <JuceHeader.h>
+#include "Oscillator.h"
+
+void generateSineWavetable(Wavetable& tableToFill, int resolution);
+void generateSquareWavetable(Wavetable& tableToFill, int resolution);
+void generateSawWavetable(Wavetable& tableToFill, int resolution);
+void generateMultiSineWavetable(Wavetable& tableToFill, int resolution, int coefficientA, int coefficientB);
+void generateRandomSineCombinations(Wavetable &tableToFill);
+void generateSineFrames(Wavetable &tableToFill, int resolution);
+void generateManySineFrames(Wavetable &);
+
+#endif // WAVETABLE_GENERATORS_H
@@ -0,0 +1,151 @@
+#ifndef BLOCK_PROFILER_H
+#define BLOCK_PROFILER_H
+
+#include <JuceHeader.h>
+#include "SpscRingBuffer.h"
+
+#define BLOCK_PROFILER_FIFO_SIZE 512
+
+enum class ProfileStage
+{
+	ParameterUpdate = 0,
+	MidiHandling,
+	VoiceRender,
+	OversampleUp,
+	OversampleDown,
+	Output,
+	NumStages
+};
+
+// timings of one processBlock call, in seconds
+struct BlockProfile
+{
+	double stageSeconds[(int) ProfileStage::NumStages]{};
+	double blockSeconds{ 0.0 };
+	double blockDurationSeconds{ 0.0 };
+
+	int numActiveVoices{ 0 };
+	int numUnisonLanes{ 0 };
+};
+
+// per-stage timing of the audio thread, handed to the editor through a wait-free
+// fifo; while disabled every call reduces to a branch on a flag read once per block
+class BlockProfiler
+{
+public:
+
+	//=============================================================================
+	BlockProfiler()
+	{
+		profiles.prepare(BLOCK_PROFILER_FIFO_SIZE);
+	}
+
+	//=============================================================================
+	// MESSAGE THREAD
+
+	void setEnabled(bool shouldBeEnabled)
+	{
+		enabled.store(shouldBeEnabled, std::memory_order_relaxed);
+	}
+
+	int popProfiles(BlockProfile *destination, int maxNumProfiles)
+	{
+		return profiles.pop(destination, maxNumProfiles);
+	}
+
+	static const char *getStageName(ProfileStage stage)
+	{
+		switch (stage)
+		{
+			case ProfileStage::ParameterUpdate: return "PARAMS";
+			case ProfileStage::MidiHandling:    return "MIDI";
+			case ProfileStage::VoiceRender:     return "VOICES";
+			case ProfileStage::OversampleUp:    return "OS UP";
+			case ProfileStage::OversampleDown:  return "OS DOWN";
+			case ProfileStage::Output:          return "OUTPUT";
+			default:                            return "";
+		}
+	}
+
+	//=============================================================================
+	// AUDIO THREAD
+
+	void beginBlock()
+	{
+		active = enabled.load(std::memory_order_relaxed);
+		if (!active)
+			return;
+
+		currentProfile = BlockProfile();
+		blockStartTicks = juce::Time::getHighResolutionTicks();
+	}
+
+	void endBlock(double blockDurationSeconds, int numActiveVoices, int numUnisonLanes)
+	{
+		if (!active)
+			return;
+
+		currentProfile.blockSeconds = ticksToSeconds(juce::Time::getHighResolutionTicks() - blockStartTicks);
+		currentProfile.blockDurationSeconds = blockDurationSeconds;
+		currentProfile.numActiveVoices = numActiveVoices;
+		currentProfile.numUnisonLanes = numUnisonLanes;
+
+		profiles.push(&currentProfile, 1);
+		active = false;
+	}
+
+	bool isActive() const
+	{
+		return active;
+	}
+
+	void addStageTicks(ProfileStage stage, juce::int64 ticks)
+	{
+		currentProfile.stageSeconds[(int) stage] += ticksToSeconds(ticks);
+	}
+
+private:
+	//=============================================================================
+	std::atomic<bool> enabled{ false };
+	SpscRingBuffer<BlockProfile> profiles;
+
+	// audio thread only
+	bool active{ false };
+	juce::int64 blockStartTicks{ 0 };
+	BlockProfile currentProfile;
+
+	static double ticksToSeconds(juce::int64 ticks)
+	{
+		return juce::Time::highResolutionTicksToSeconds(ticks);
+	}
+};
+
+// adds the time until the end of the scope to a stage of the current block;
+// a null or inactive profiler costs one branch
+class ScopedProfileStage
+{
+public:
+
+	ScopedProfileStage(BlockProfiler *profilerToUse, ProfileStage stageToTime) :
+		profiler(profilerToUse != nullptr && profilerToUse->isActive() ? profilerToUse : nullptr),
+		stage(stageToTime)
+	{
+		if (profiler != nullptr)
+			startTicks = juce::Time::getHighResolutionTicks();
+	}
+
+	~ScopedProfileStage()
+	{
+		if (profiler != nullptr)
+			profiler->addStageTicks(stage, juce::Time::getHighResolutionTicks() - startTicks);
+	}
+
+private:
+	BlockProfiler *profiler;
+	ProfileStage stage;
+	juce::int64 startTicks{ 0 };
+
+	JUCE_DECLARE_NON_COPYABLE(ScopedProfileStage)
+};
+
+#endif // BLOCK_PROFILER_H
@@ -0,0 +1,110 @@
+#ifndef MPMC_QUEUE_H
+#define MPMC_QUEUE_H
+
+#include <JuceHeader.h>
+
+// bounded lock-free multi producer / multi consumer queue of pointers, after
+// Dmitry Vyukov's sequence-numbered ring; used to hand work to a pool from
+// threads that do not own a deque of their own
+template <typename T>
+class MpmcQueue
+{
+public:
+
+	//=============================================================================
+	// must be called before any thread uses the queue
+	void prepare(int minimumCapacity)
+	{
+		capacity = (size_t) juce::nextPowerOfTwo(juce::jmax(2, minimumCapacity));
+		mask = capacity - 1;
+		cells.reset(new Cell[capacity]);
+		for (size_t i = 0; i < capacity; ++i)
+		{
+			cells[i].sequence.store(i, std::memory_order_relaxed);
+			cells[i].item = nullptr;
+		}
+
+		enqueuePosition.store(0);
+		dequeuePosition.store(0);
+	}
+
+	//=============================================================================
+	// false when full
+	bool push(T *item)
+	{
+		auto position = enqueuePosition.load(std::memory_order_relaxed);
+
+		for (;;)
+		{
+			auto &cell = cells[position & mask];
+			const auto sequence = cell.sequence.load(std::memory_order_acquire);
+			const auto difference = (std::ptrdiff_t) sequence - (std::ptrdiff_t) position;
+
+			if (difference == 0)
+			{
+				if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				{
+					cell.item = item;
+					cell.sequence.store(position + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (difference < 0)
+			{
+				return false;
+			}
+			else
+			{
+				position = enqueuePosition.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	// nullptr when empty
+	T *pop()
+	{
+		auto position = dequeuePosition.load(std::memory_order_relaxed);
+
+		for (;;)
+		{
+			auto &cell = cells[position & mask];
+			const auto sequence = cell.sequence.load(std::memory_order_acquire);
+			const auto difference = (std::ptrdiff_t) sequence - (std::ptrdiff_t) (position + 1);
+
+			if (difference == 0)
+			{
+				if (dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				{
+					auto *item = cell.item;
+					cell.sequence.store(position + mask + 1, std::memory_order_release);
+					return item;
+				}
+			}
+			else if (difference < 0)
+			{
+				return nullptr;
+			}
+			else
+			{
+				position = dequeuePosition.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+private:
+	//=============================================================================
+	struct Cell
+	{
+		std::atomic<size_t> sequence{ 0 };
+		T *item{ nullptr };
+	};
+
+	std::unique_ptr<Cell[]> cells;
+	size_t capacity{ 0 };
+	size_t mask{ 0 };
+
+	alignas(64) std::atomic<size_t> enqueuePosition{ 0 };
+	alignas(64) std::atomic<size_t> dequeuePosition{ 0 };
+};
+
+#endif // MPMC_QUEUE_H
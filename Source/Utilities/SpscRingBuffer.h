@@ -0,0 +1,114 @@
+#ifndef SPSC_RING_BUFFER_H
+#define SPSC_RING_BUFFER_H
+
+#include <JuceHeader.h>
+
+// wait-free single producer / single consumer ring buffer of trivially copyable
+// values; storage is allocated once up front and writes that do not fit are dropped
+template <typename T>
+class SpscRingBuffer
+{
+public:
+
+	//=============================================================================
+	// must be called before either side starts, and never while they are running
+	void prepare(int minimumCapacity)
+	{
+		capacity = (size_t) juce::nextPowerOfTwo(juce::jmax(2, minimumCapacity));
+		mask = capacity - 1;
+		storage.allocate(capacity, true);
+		readPosition.store(0);
+		writePosition.store(0);
+		numDropped.store(0);
+	}
+
+	int getCapacity() const
+	{
+		return (int) capacity;
+	}
+
+	//=============================================================================
+	// PRODUCER
+
+	// writes as many values as fit; the rest are counted as dropped
+	int push(const T *values, int numValues)
+	{
+		const size_t write = writePosition.load(std::memory_order_relaxed);
+		const size_t read = readPosition.load(std::memory_order_acquire);
+		const size_t freeSpace = capacity - (write - read);
+		const size_t numToWrite = juce::jmin(freeSpace, (size_t) juce::jmax(0, numValues));
+
+		for (size_t i = 0; i < numToWrite; ++i)
+		{
+			storage[(write + i) & mask] = values[i];
+		}
+
+		writePosition.store(write + numToWrite, std::memory_order_release);
+
+		if (numToWrite < (size_t) numValues)
+			numDropped.fetch_add(numValues - (int) numToWrite, std::memory_order_relaxed);
+
+		return (int) numToWrite;
+	}
+
+	int getFreeSpace() const
+	{
+		return (int) (capacity - (writePosition.load(std::memory_order_relaxed) - readPosition.load(std::memory_order_acquire)));
+	}
+
+	//=============================================================================
+	// CONSUMER
+
+	int pop(T *destination, int maxNumValues)
+	{
+		const size_t read = readPosition.load(std::memory_order_relaxed);
+		const size_t write = writePosition.load(std::memory_order_acquire);
+		const size_t numToRead = juce::jmin(write - read, (size_t) juce::jmax(0, maxNumValues));
+
+		for (size_t i = 0; i < numToRead; ++i)
+		{
+			destination[i] = storage[(read + i) & mask];
+		}
+
+		readPosition.store(read + numToRead, std::memory_order_release);
+		return (int) numToRead;
+	}
+
+	// copies without consuming, so the consumer can decide how much to take
+	int peek(T *destination, int maxNumValues) const
+	{
+		const size_t read = readPosition.load(std::memory_order_relaxed);
+		const size_t write = writePosition.load(std::memory_order_acquire);
+		const size_t numToRead = juce::jmin(write - read, (size_t) juce::jmax(0, maxNumValues));
+
+		for (size_t i = 0; i < numToRead; ++i)
+		{
+			destination[i] = storage[(read + i) & mask];
+		}
+
+		return (int) numToRead;
+	}
+
+	int getNumReady() const
+	{
+		return (int) (writePosition.load(std::memory_order_acquire) - readPosition.load(std::memory_order_relaxed));
+	}
+
+	// values the producer had to throw away since prepare()
+	int getNumDropped() const
+	{
+		return numDropped.load(std::memory_order_relaxed);
+	}
+
+private:
+	//=============================================================================
+	juce::HeapBlock<T> storage;
+	size_t capacity{ 0 };
+	size_t mask{ 0 };
+
+	std::atomic<size_t> readPosition{ 0 };
+	std::atomic<size_t> writePosition{ 0 };
+	std::atomic<int> numDropped{ 0 };
+};
+
+#endif // SPSC_RING_BUFFER_H
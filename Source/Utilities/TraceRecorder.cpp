@@ -0,0 +1,189 @@
+#include "TraceRecorder.h"
+
+#if WAVETABLESYNTH_TRACING
+
+static std::atomic<TraceRecorder *> activeRecorder{ nullptr };
+static std::atomic<int> nextSession{ 0 };
+
+//=============================================================================
+// CONSTRUCTORS / DESTRUCTORS
+
+TraceRecorder::TraceRecorder() :
+    juce::Thread("Trace Writer")
+{
+    session = nextSession.fetch_add(1) + 1;
+    startTicks = juce::Time::getHighResolutionTicks();
+    flushScratch.allocate(TRACE_EVENTS_PER_THREAD, false);
+
+    auto traceDirectory = juce::File::getSpecialLocation(juce::File::userDocumentsDirectory).getChildFile("WavetableSynth Traces");
+    traceDirectory.createDirectory();
+
+    auto timestamp = juce::Time::getCurrentTime().formatted("%Y-%m-%d_%H-%M-%S");
+    traceFile = traceDirectory.getNonexistentChildFile("trace_" + timestamp, ".json", false);
+
+    output = std::make_unique<juce::FileOutputStream>(traceFile);
+    if (!output->openedOk())
+    {
+        DBG("TraceRecorder: could not open " << traceFile.getFullPathName());
+        output.reset();
+        return;
+    }
+
+    // json array format; perfetto also accepts the file if the closing bracket is missing
+    *output << "[";
+
+    activeRecorder.store(this, std::memory_order_release);
+    startThread();
+}
+
+TraceRecorder::~TraceRecorder()
+{
+    TraceRecorder *expected = this;
+    activeRecorder.compare_exchange_strong(expected, nullptr);
+
+    stopThread(2000);
+
+    if (output != nullptr)
+    {
+        *output << "\n]\n";
+        output->flush();
+    }
+}
+
+TraceRecorder *TraceRecorder::getActiveRecorder()
+{
+    return activeRecorder.load(std::memory_order_acquire);
+}
+
+juce::File TraceRecorder::getTraceFile() const
+{
+    return traceFile;
+}
+
+//=============================================================================
+// TRACED THREADS
+
+void TraceRecorder::addEvent(const TraceEvent &event)
+{
+    if (auto *thread = getEventsForCurrentThread())
+        thread->events.push(&event, 1);
+}
+
+TraceRecorder::ThreadEvents *TraceRecorder::getEventsForCurrentThread()
+{
+    struct ThreadLookup
+    {
+        int session = 0;
+        ThreadEvents *events = nullptr;
+    };
+    thread_local ThreadLookup lookup;
+
+    if (lookup.session != session)
+    {
+        lookup.events = registerCurrentThread();
+        lookup.session = session;
+    }
+
+    return lookup.events;
+}
+
+// threads past TRACE_MAX_THREADS are not traced
+TraceRecorder::ThreadEvents *TraceRecorder::registerCurrentThread()
+{
+    const juce::ScopedLock lock(registrationLock);
+
+    const int threadIndex = numThreads.load(std::memory_order_relaxed);
+    if (threadIndex >= TRACE_MAX_THREADS)
+        return nullptr;
+
+    auto thread = std::make_unique<ThreadEvents>();
+    thread->events.prepare(TRACE_EVENTS_PER_THREAD);
+    thread->threadIndex = threadIndex + 1;
+
+    if (auto *juceThread = juce::Thread::getCurrentThread())
+        thread->threadName = juceThread->getThreadName();
+    else if (juce::MessageManager::existsAndIsCurrentThread())
+        thread->threadName = "Message Thread";
+    else
+        thread->threadName = "Thread " + juce::String(thread->threadIndex);
+
+    auto *events = thread.get();
+    threads[threadIndex] = std::move(thread);
+    numThreads.store(threadIndex + 1, std::memory_order_release);
+
+    return events;
+}
+
+//=============================================================================
+// WRITER THREAD
+
+void TraceRecorder::run()
+{
+    while (!threadShouldExit())
+    {
+        flush();
+        wait(TRACE_FLUSH_INTERVAL_MS);
+    }
+
+    flush();
+
+    // report overflow so gaps in the trace are not mistaken for idle time
+    const auto endMicroseconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) * 1.0e6;
+    for (int threadIndex = 0; threadIndex < numThreads.load(std::memory_order_acquire); ++threadIndex)
+    {
+        const auto &thread = *threads[threadIndex];
+        const int numDropped = thread.events.getNumDropped();
+        if (numDropped > 0)
+        {
+            writeRecord("{\"name\":\"dropped events\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":" + juce::String(thread.threadIndex)
+                        + ",\"ts\":" + juce::String(endMicroseconds, 3) + ",\"args\":{\"count\":" + juce::String(numDropped) + "}}");
+        }
+    }
+}
+
+void TraceRecorder::flush()
+{
+    if (output == nullptr)
+        return;
+
+    for (int threadIndex = 0; threadIndex < numThreads.load(std::memory_order_acquire); ++threadIndex)
+    {
+        auto &thread = *threads[threadIndex];
+
+        if (!thread.nameWritten)
+            writeThreadName(thread);
+
+        const int numEvents = thread.events.pop(flushScratch.get(), TRACE_EVENTS_PER_THREAD);
+        for (int eventIndex = 0; eventIndex < numEvents; ++eventIndex)
+        {
+            writeEvent(thread, flushScratch[eventIndex]);
+        }
+    }
+
+    output->flush();
+}
+
+// one complete ("X") event; timestamps are microseconds since the recorder started
+void TraceRecorder::writeEvent(const ThreadEvents &thread, const TraceEvent &event)
+{
+    const auto startMicroseconds = juce::Time::highResolutionTicksToSeconds(event.startTicks - startTicks) * 1.0e6;
+    const auto durationMicroseconds = juce::Time::highResolutionTicksToSeconds(event.endTicks - event.startTicks) * 1.0e6;
+
+    writeRecord("{\"name\":\"" + juce::String(event.name) + "\",\"ph\":\"X\",\"pid\":1,\"tid\":" + juce::String(thread.threadIndex)
+                + ",\"ts\":" + juce::String(startMicroseconds, 3) + ",\"dur\":" + juce::String(durationMicroseconds, 3) + "}");
+}
+
+void TraceRecorder::writeThreadName(ThreadEvents &thread)
+{
+    writeRecord("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + juce::String(thread.threadIndex)
+                + ",\"args\":{\"name\":" + juce::JSON::toString(thread.threadName) + "}}");
+    thread.nameWritten = true;
+}
+
+void TraceRecorder::writeRecord(const juce::String &record)
+{
+    *output << (firstEventWritten ? ",\n" : "\n") << record;
+    firstEventWritten = true;
+}
+
+#endif // WAVETABLESYNTH_TRACING
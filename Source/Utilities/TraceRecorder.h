@@ -0,0 +1,131 @@
+#ifndef TRACE_RECORDER_H
+#define TRACE_RECORDER_H
+
+#include <JuceHeader.h>
+
+// hot path tracing, compiled out unless WAVETABLESYNTH_TRACING=1 is added to the
+// exporter's preprocessor definitions; with it off TRACE_SCOPE expands to nothing
+#ifndef WAVETABLESYNTH_TRACING
+	#define WAVETABLESYNTH_TRACING 0
+#endif
+
+#if WAVETABLESYNTH_TRACING
+
+#include "SpscRingBuffer.h"
+
+#define TRACE_MAX_THREADS 32
+#define TRACE_EVENTS_PER_THREAD 16384
+#define TRACE_FLUSH_INTERVAL_MS 100
+
+#define TRACE_SCOPE_CONCAT_INNER(a, b) a##b
+#define TRACE_SCOPE_CONCAT(a, b) TRACE_SCOPE_CONCAT_INNER(a, b)
+
+// times the enclosing scope; name must be a string literal
+#define TRACE_SCOPE(name) ScopedTraceEvent TRACE_SCOPE_CONCAT(scopedTraceEvent, __LINE__)(name)
+
+struct TraceEvent
+{
+	const char *name{ nullptr };
+	juce::int64 startTicks{ 0 };
+	juce::int64 endTicks{ 0 };
+};
+
+// collects scoped timestamps from any thread into per-thread wait-free fifos and
+// streams them to a chrome trace-event json file that perfetto or chrome://tracing
+// can open; the file is written by a background thread, never by the traced ones
+class TraceRecorder : private juce::Thread
+{
+public:
+
+	//=============================================================================
+	TraceRecorder();
+	~TraceRecorder() override;
+
+	// the recorder that scoped events currently report to, or nullptr
+	static TraceRecorder *getActiveRecorder();
+
+	juce::File getTraceFile() const;
+
+	//=============================================================================
+	// TRACED THREADS
+
+	// the first event on a thread registers a fifo for it, which takes a lock and
+	// allocates once; every later event is a single wait-free push
+	void addEvent(const TraceEvent &event);
+
+private:
+	//=============================================================================
+	struct ThreadEvents
+	{
+		SpscRingBuffer<TraceEvent> events;
+		int threadIndex{ 0 };
+		juce::String threadName;
+		bool nameWritten{ false };
+	};
+
+	std::unique_ptr<ThreadEvents> threads[TRACE_MAX_THREADS];
+	std::atomic<int> numThreads{ 0 };
+	juce::CriticalSection registrationLock;
+
+	// bumped for every recorder so thread-local lookups never reuse a dead one
+	int session;
+
+	ThreadEvents *getEventsForCurrentThread();
+	ThreadEvents *registerCurrentThread();
+
+	//=============================================================================
+	// WRITER THREAD
+
+	juce::File traceFile;
+	std::unique_ptr<juce::FileOutputStream> output;
+	juce::HeapBlock<TraceEvent> flushScratch;
+	juce::int64 startTicks;
+	bool firstEventWritten{ false };
+
+	void run() override;
+	void flush();
+	void writeEvent(const ThreadEvents &thread, const TraceEvent &event);
+	void writeThreadName(ThreadEvents &thread);
+	void writeRecord(const juce::String &record);
+
+	JUCE_DECLARE_NON_COPYABLE(TraceRecorder)
+};
+
+// records the time from construction to destruction as one complete event
+class ScopedTraceEvent
+{
+public:
+
+	explicit ScopedTraceEvent(const char *nameToUse) :
+		recorder(TraceRecorder::getActiveRecorder())
+	{
+		if (recorder != nullptr)
+		{
+			event.name = nameToUse;
+			event.startTicks = juce::Time::getHighResolutionTicks();
+		}
+	}
+
+	~ScopedTraceEvent()
+	{
+		if (recorder != nullptr)
+		{
+			event.endTicks = juce::Time::getHighResolutionTicks();
+			recorder->addEvent(event);
+		}
+	}
+
+private:
+	TraceRecorder *recorder;
+	TraceEvent event;
+
+	JUCE_DECLARE_NON_COPYABLE(ScopedTraceEvent)
+};
+
+#else
+
+#define TRACE_SCOPE(name)
+
+#endif // WAVETABLESYNTH_TRACING
+
+#endif // TRACE_RECORDER_H
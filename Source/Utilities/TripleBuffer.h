@@ -0,0 +1,57 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <JuceHeader.h>
+
+// lock-free handoff of the latest value of T from one producer thread to one
+// consumer thread; neither side ever waits, and the consumer always reads a
+// complete copy that the producer is no longer touching
+template <typename T>
+class TripleBuffer
+{
+public:
+
+	//=============================================================================
+	// PRODUCER
+
+	T &getWriteBuffer()
+	{
+		return buffers[writeIndex];
+	}
+
+	// swap the finished write buffer into the middle slot and mark it fresh
+	void publish()
+	{
+		writeIndex = middleIndex.exchange(writeIndex | freshBit, std::memory_order_acq_rel) & indexMask;
+	}
+
+	//=============================================================================
+	// CONSUMER
+
+	// take the middle slot if the producer published since the last update
+	bool update()
+	{
+		if ((middleIndex.load(std::memory_order_relaxed) & freshBit) == 0)
+			return false;
+
+		readIndex = middleIndex.exchange(readIndex, std::memory_order_acq_rel) & indexMask;
+		return true;
+	}
+
+	const T &getReadBuffer() const
+	{
+		return buffers[readIndex];
+	}
+
+private:
+	//=============================================================================
+	static constexpr int indexMask = 3;
+	static constexpr int freshBit = 4;
+
+	T buffers[3]{};
+	int writeIndex = 0;
+	int readIndex = 1;
+	std::atomic<int> middleIndex{ 2 };
+};
+
+#endif // TRIPLE_BUFFER_H
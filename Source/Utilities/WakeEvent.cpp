@@ -0,0 +1,143 @@
+#include "WakeEvent.h"
+
+#if JUCE_WINDOWS
+    #include <windows.h>
+#elif JUCE_MAC || JUCE_IOS
+    #include <dispatch/dispatch.h>
+#else
+    #include <semaphore.h>
+    #include <errno.h>
+    #include <time.h>
+#endif
+
+//=============================================================================
+// NATIVE SEMAPHORE
+
+// only posted by signal() when state was -1, so its count never goes above one
+#if JUCE_WINDOWS
+
+struct WakeEvent::NativeSemaphore
+{
+    HANDLE handle{ CreateSemaphoreW(nullptr, 0, 1, nullptr) };
+    ~NativeSemaphore() { CloseHandle(handle); }
+
+    void post() { ReleaseSemaphore(handle, 1, nullptr); }
+
+    bool wait(int timeoutMilliseconds)
+    {
+        return WaitForSingleObject(handle, timeoutMilliseconds < 0 ? INFINITE : (DWORD) timeoutMilliseconds) == WAIT_OBJECT_0;
+    }
+};
+
+#elif JUCE_MAC || JUCE_IOS
+
+struct WakeEvent::NativeSemaphore
+{
+    dispatch_semaphore_t handle{ dispatch_semaphore_create(0) };
+    ~NativeSemaphore() { dispatch_release(handle); }
+
+    void post() { dispatch_semaphore_signal(handle); }
+
+    bool wait(int timeoutMilliseconds)
+    {
+        const auto timeout = timeoutMilliseconds < 0 ? DISPATCH_TIME_FOREVER
+                                                     : dispatch_time(DISPATCH_TIME_NOW, (int64_t) timeoutMilliseconds * 1000000);
+        return dispatch_semaphore_wait(handle, timeout) == 0;
+    }
+};
+
+#else
+
+struct WakeEvent::NativeSemaphore
+{
+    sem_t handle;
+    NativeSemaphore() { sem_init(&handle, 0, 0); }
+    ~NativeSemaphore() { sem_destroy(&handle); }
+
+    void post() { sem_post(&handle); }
+
+    bool wait(int timeoutMilliseconds)
+    {
+        if (timeoutMilliseconds < 0)
+        {
+            while (sem_wait(&handle) != 0)
+                if (errno != EINTR)
+                    return false;
+
+            return true;
+        }
+
+        // sem_timedwait takes an absolute time on the realtime clock
+        timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += timeoutMilliseconds / 1000;
+        deadline.tv_nsec += (long) (timeoutMilliseconds % 1000) * 1000000;
+        if (deadline.tv_nsec >= 1000000000)
+        {
+            deadline.tv_sec += 1;
+            deadline.tv_nsec -= 1000000000;
+        }
+
+        while (sem_timedwait(&handle, &deadline) != 0)
+            if (errno != EINTR)
+                return false;
+
+        return true;
+    }
+};
+
+#endif
+
+//=============================================================================
+// CONSTRUCTORS / DESTRUCTORS
+
+WakeEvent::WakeEvent() :
+    semaphore(std::make_unique<NativeSemaphore>())
+{
+}
+
+WakeEvent::~WakeEvent() {}
+
+//=============================================================================
+// WAIT / SIGNAL
+
+bool WakeEvent::wait(int timeoutMilliseconds)
+{
+    const int previousState = state.fetch_sub(1, std::memory_order_acquire);
+    jassert(previousState >= 0);
+
+    if (previousState > 0)
+        return true;
+
+    if (semaphore->wait(timeoutMilliseconds))
+        return true;
+
+    // timed out; unless a signal came in meanwhile, in which case its post is on its way
+    int expected = -1;
+    if (state.compare_exchange_strong(expected, 0, std::memory_order_acquire))
+        return false;
+
+    semaphore->wait(-1);
+    return true;
+}
+
+void WakeEvent::signal()
+{
+    int current = state.load(std::memory_order_relaxed);
+    while (current < 1)
+    {
+        if (state.compare_exchange_weak(current, current + 1, std::memory_order_release, std::memory_order_relaxed))
+        {
+            if (current < 0)
+                semaphore->post();
+
+            return;
+        }
+    }
+}
+
+void WakeEvent::reset()
+{
+    int expected = 1;
+    state.compare_exchange_strong(expected, 0, std::memory_order_relaxed);
+}
@@ -0,0 +1,39 @@
+#ifndef WAKE_EVENT_H
+#define WAKE_EVENT_H
+
+#include <JuceHeader.h>
+
+// an auto-reset event like juce::WaitableEvent for one waiting thread, whose signal never
+// locks: an atomic update, plus a semaphore post only when the waiter is actually asleep.
+// signals before a wait are not lost, and several of them wake the waiter once
+class WakeEvent
+{
+public:
+
+	//=============================================================================
+	WakeEvent();
+	~WakeEvent();
+
+	//=============================================================================
+	// true when signalled, false after timeoutMilliseconds; a negative timeout waits forever.
+	// only ever one thread at a time may wait
+	bool wait(int timeoutMilliseconds = -1);
+
+	// safe from the audio thread
+	void signal();
+
+	// drops a signal nobody has waited for yet; never while a thread waits
+	void reset();
+
+private:
+	//=============================================================================
+	// 1 signalled, 0 idle, -1 a thread is waiting on the semaphore
+	std::atomic<int> state{ 0 };
+
+	struct NativeSemaphore;
+	std::unique_ptr<NativeSemaphore> semaphore;
+
+	JUCE_DECLARE_NON_COPYABLE(WakeEvent)
+};
+
+#endif // WAKE_EVENT_H
@@ -0,0 +1,106 @@
+#ifndef WORK_STEALING_DEQUE_H
+#define WORK_STEALING_DEQUE_H
+
+#include <JuceHeader.h>
+
+// fixed-capacity chase-lev deque of pointers: the owning thread pushes and pops at the
+// bottom without contention, any other thread may steal from the top
+template <typename T>
+class WorkStealingDeque
+{
+public:
+
+	//=============================================================================
+	// must be called before any thread uses the deque
+	void prepare(int minimumCapacity)
+	{
+		capacity = (juce::int64) juce::nextPowerOfTwo(juce::jmax(2, minimumCapacity));
+		mask = capacity - 1;
+		items.reset(new std::atomic<T *>[(size_t) capacity]);
+		for (juce::int64 i = 0; i < capacity; ++i)
+			items[(size_t) i].store(nullptr, std::memory_order_relaxed);
+
+		top.store(0);
+		bottom.store(0);
+	}
+
+	//=============================================================================
+	// OWNER
+
+	// false when full, the caller then runs the item itself
+	bool push(T *item)
+	{
+		const auto b = bottom.load(std::memory_order_relaxed);
+		const auto t = top.load(std::memory_order_acquire);
+		if (b - t >= capacity)
+			return false;
+
+		items[(size_t) (b & mask)].store(item, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		bottom.store(b + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	T *pop()
+	{
+		const auto b = bottom.load(std::memory_order_relaxed) - 1;
+		bottom.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		auto t = top.load(std::memory_order_relaxed);
+
+		if (t > b)
+		{
+			bottom.store(b + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		auto *item = items[(size_t) (b & mask)].load(std::memory_order_relaxed);
+
+		// the last item may be raced for by a thief
+		if (t == b)
+		{
+			if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				item = nullptr;
+
+			bottom.store(b + 1, std::memory_order_relaxed);
+		}
+
+		return item;
+	}
+
+	//=============================================================================
+	// ANY THREAD
+
+	// nullptr when empty or when another thread won the race for the top item
+	T *steal()
+	{
+		auto t = top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const auto b = bottom.load(std::memory_order_acquire);
+
+		if (t >= b)
+			return nullptr;
+
+		auto *item = items[(size_t) (t & mask)].load(std::memory_order_relaxed);
+		if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			return nullptr;
+
+		return item;
+	}
+
+	bool isEmpty() const
+	{
+		return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+	}
+
+private:
+	//=============================================================================
+	std::unique_ptr<std::atomic<T *>[]> items;
+	juce::int64 capacity{ 0 };
+	juce::int64 mask{ 0 };
+
+	std::atomic<juce::int64> top{ 0 };
+	std::atomic<juce::int64> bottom{ 0 };
+};
+
+#endif // WORK_STEALING_DEQUE_H
@@ -0,0 +1,384 @@
+#include "WorkerPool.h"
+
+//=============================================================================
+// WORKER
+
+class WorkerPool::Worker : public juce::Thread
+{
+public:
+
+    Worker(WorkerPool &ownerPool, int index) :
+        juce::Thread("WavetableSynth Worker " + juce::String(index)),
+        pool(ownerPool),
+        workerIndex(index)
+    {
+        deque.prepare(WORKER_POOL_DEQUE_SIZE);
+        inbox.prepare(WORKER_POOL_INBOX_SIZE);
+    }
+
+    ~Worker() override
+    {
+        signalThreadShouldExit();
+        wakeEvent.signal();
+        stopThread(1000);
+    }
+
+    void start()
+    {
+        // render work sits next to the host's audio thread in priority
+        if (!startRealtimeThread(juce::Thread::RealtimeOptions{}.withPriority(8)))
+            startThread(juce::Thread::Priority::highest);
+    }
+
+    // true when the worker was asleep and has been woken. the caller has just queued a task;
+    // the fence orders that before reading sleeping, as the worker orders setting sleeping
+    // before looking at the queues once more, so one of the two always sees the other
+    bool wake()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!sleeping.load(std::memory_order_seq_cst))
+            return false;
+
+        wakeEvent.signal();
+        return true;
+    }
+
+    static Worker *getCurrentWorker(const WorkerPool &ownerPool)
+    {
+        return currentWorker != nullptr && &currentWorker->pool == &ownerPool ? currentWorker : nullptr;
+    }
+
+    // the first task to run now; everything else sent to this worker moves onto its deque,
+    // where idle workers steal it
+    WorkerTask *takeInbox()
+    {
+        auto *first = inbox.pop();
+        if (first == nullptr)
+            return nullptr;
+
+        while (auto *task = inbox.pop())
+        {
+            if (!deque.push(task))
+                WorkerPool::executeQueued(task);
+        }
+
+        return first;
+    }
+
+    // after the thread has stopped: drops what is still queued without running it
+    void releaseQueuedTasks()
+    {
+        jassert(!isThreadRunning());
+
+        while (auto *task = deque.pop())
+            task->numQueuedCopies.fetch_sub(1, std::memory_order_release);
+
+        while (auto *task = inbox.pop())
+            task->numQueuedCopies.fetch_sub(1, std::memory_order_release);
+    }
+
+    // only the owning worker pushes and pops here
+    WorkStealingDeque<WorkerTask> deque;
+
+    // tasks handed to this worker by threads outside the pool
+    MpmcQueue<WorkerTask> inbox;
+
+private:
+    WorkerPool &pool;
+    const int workerIndex;
+
+    std::atomic<bool> sleeping{ false };
+    WakeEvent wakeEvent;
+
+    static thread_local Worker *currentWorker;
+
+    void run() override
+    {
+        currentWorker = this;
+        int numIdleSpins = 0;
+
+        // the audio thread renders with flush-to-zero, so the workers must as well
+        juce::ScopedNoDenormals noDenormals;
+
+        while (!threadShouldExit())
+        {
+            if (auto *task = pool.findTask(workerIndex))
+            {
+                WorkerPool::executeQueued(task);
+                numIdleSpins = 0;
+                continue;
+            }
+
+            // stay hot for a moment so back-to-back blocks do not pay for a wake-up
+            if (++numIdleSpins < WORKER_POOL_IDLE_SPINS)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            sleeping.store(true, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            // look once more so a task pushed just before sleeping is not missed
+            if (auto *task = pool.findTask(workerIndex))
+            {
+                sleeping.store(false, std::memory_order_relaxed);
+                WorkerPool::executeQueued(task);
+                continue;
+            }
+
+            wakeEvent.wait(WORKER_POOL_IDLE_WAIT_MS);
+            sleeping.store(false, std::memory_order_relaxed);
+            numIdleSpins = 0;
+        }
+
+        currentWorker = nullptr;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE(Worker)
+};
+
+thread_local WorkerPool::Worker *WorkerPool::Worker::currentWorker = nullptr;
+
+//=============================================================================
+// CONSTRUCTORS / DESTRUCTORS
+
+// one worker per physical core less the one the host's audio thread runs on,
+// which helps with its own tasks while it waits
+WorkerPool::WorkerPool() :
+    backgroundPool(juce::ThreadPoolOptions{}
+                       .withThreadName("WavetableSynth Background")
+                       .withNumberOfThreads(1)
+                       .withDesiredThreadPriority(juce::Thread::Priority::background))
+{
+    const int numWorkers = juce::jlimit(1, WORKER_POOL_MAX_WORKERS, juce::SystemStats::getNumPhysicalCpus() - 1);
+    for (int workerIndex = 0; workerIndex < numWorkers; ++workerIndex)
+    {
+        workers.add(new Worker(*this, workerIndex));
+    }
+
+    for (auto *worker : workers)
+    {
+        worker->start();
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    backgroundPool.removeAllJobs(true, 2000);
+
+    // task groups wait for their queued copies to be let go of before freeing them
+    for (auto *worker : workers)
+    {
+        worker->signalThreadShouldExit();
+        worker->wake();
+    }
+
+    for (auto *worker : workers)
+    {
+        worker->stopThread(1000);
+        worker->releaseQueuedTasks();
+    }
+
+    workers.clear();
+}
+
+int WorkerPool::getNumWorkers() const
+{
+    return workers.size();
+}
+
+//=============================================================================
+// REAL-TIME
+
+void WorkerPool::runTasks(WorkerTask *tasks, int numTasks)
+{
+    if (numTasks <= 0)
+        return;
+
+    // a task that itself forks keeps the new tasks on its worker's deque, where idle
+    // workers steal them; any other thread deals the batch out across the workers' inboxes,
+    // starting one further along each time so concurrent instances spread out too
+    auto *currentWorker = Worker::getCurrentWorker(*this);
+    const int numWorkers = workers.size();
+    const auto firstWorkerIndex = nextWorkerIndex.fetch_add(1, std::memory_order_relaxed);
+    int numQueued = 0;
+
+    for (int taskIndex = 1; taskIndex < numTasks; ++taskIndex)
+    {
+        auto *task = tasks + taskIndex;
+
+        task->numQueuedCopies.fetch_add(1, std::memory_order_relaxed);
+
+        if (currentWorker != nullptr)
+        {
+            if (currentWorker->deque.push(task))
+            {
+                ++numQueued;
+                continue;
+            }
+        }
+        else
+        {
+            auto *worker = workers.getUnchecked((int) ((firstWorkerIndex + (unsigned int) taskIndex) % (unsigned int) numWorkers));
+            if (worker->inbox.push(task))
+            {
+                worker->wake();
+                continue;
+            }
+        }
+
+        task->numQueuedCopies.fetch_sub(1, std::memory_order_relaxed);
+        execute(task);
+    }
+
+    wakeWorkers(numQueued);
+    execute(tasks);
+
+    waitForBatch(tasks, numTasks);
+}
+
+// claims whatever the workers have not started yet, from the back of the batch where they
+// are least likely to be, then waits for the rest. never runs another batch's tasks, so one
+// instance's render cannot be held up by another's
+void WorkerPool::waitForBatch(WorkerTask *tasks, int numTasks)
+{
+    for (int taskIndex = numTasks - 1; taskIndex > 0; --taskIndex)
+        execute(tasks + taskIndex);
+
+    auto &numRemaining = *tasks[0].numRemaining;
+    while (numRemaining.load(std::memory_order_acquire) > 0)
+        std::this_thread::yield();
+}
+
+// own deque first, then own inbox, then steal from the other workers' deques and finally
+// take from their inboxes, in case one of them is asleep
+WorkerTask *WorkerPool::findTask(int workerIndex)
+{
+    auto *worker = workers.getUnchecked(workerIndex);
+
+    if (auto *task = worker->deque.pop())
+        return task;
+
+    if (auto *task = worker->takeInbox())
+        return task;
+
+    const int numWorkers = workers.size();
+    for (int offset = 1; offset < numWorkers; ++offset)
+    {
+        if (auto *task = workers.getUnchecked((workerIndex + offset) % numWorkers)->deque.steal())
+            return task;
+    }
+
+    for (int offset = 1; offset < numWorkers; ++offset)
+    {
+        if (auto *task = workers.getUnchecked((workerIndex + offset) % numWorkers)->inbox.pop())
+            return task;
+    }
+
+    return nullptr;
+}
+
+void WorkerPool::wakeWorkers(int numToWake)
+{
+    for (auto *worker : workers)
+    {
+        if (numToWake <= 0)
+            return;
+
+        if (worker->wake())
+            --numToWake;
+    }
+}
+
+// a task can sit in more than one place, e.g. still queued after the submitter ran it
+// itself; only the first thread to claim it runs it
+void WorkerPool::execute(WorkerTask *task)
+{
+    if (task->claimed.exchange(true, std::memory_order_acq_rel))
+        return;
+
+    task->function(task->context, task->taskIndex);
+    task->numRemaining->fetch_sub(1, std::memory_order_acq_rel);
+}
+
+// for a task taken off a deque or inbox; the task is not touched after giving up the copy
+void WorkerPool::executeQueued(WorkerTask *task)
+{
+    execute(task);
+    task->numQueuedCopies.fetch_sub(1, std::memory_order_release);
+}
+
+//=============================================================================
+// BACKGROUND
+
+void WorkerPool::addBackgroundJob(juce::ThreadPoolJob *job, bool deleteJobWhenFinished)
+{
+    backgroundPool.addJob(job, deleteJobWhenFinished);
+}
+
+void WorkerPool::addBackgroundJob(std::function<void()> job)
+{
+    backgroundPool.addJob(std::move(job));
+}
+
+bool WorkerPool::removeBackgroundJobs(std::function<bool(juce::ThreadPoolJob *)> selector, int timeoutMilliseconds)
+{
+    struct FunctionJobSelector : public juce::ThreadPool::JobSelector
+    {
+        std::function<bool(juce::ThreadPoolJob *)> function;
+        bool isJobSuitable(juce::ThreadPoolJob *job) override { return function(job); }
+    };
+
+    FunctionJobSelector jobSelector;
+    jobSelector.function = std::move(selector);
+    return backgroundPool.removeAllJobs(true, timeoutMilliseconds, &jobSelector);
+}
+
+//=============================================================================
+// TASK GROUP
+
+WorkerTaskGroup::~WorkerTaskGroup()
+{
+    waitForQueuedCopies();
+}
+
+void WorkerTaskGroup::prepare(int maximumNumTasks)
+{
+    waitForQueuedCopies();
+
+    capacity = juce::jmax(1, maximumNumTasks);
+    tasks.reset(new WorkerTask[(size_t) capacity]);
+}
+
+void WorkerTaskGroup::run(WorkerPool &pool, WorkerTask::Function function, void *context, int numTasks)
+{
+    jassert(numTasks <= capacity);
+    numTasks = juce::jmin(numTasks, capacity);
+    if (numTasks <= 0)
+        return;
+
+    // a copy of a task from an earlier batch can still be queued; it is skipped until
+    // claimed is cleared here, after which it runs this batch's task correctly
+    numRemaining.store(numTasks, std::memory_order_relaxed);
+    for (int taskIndex = 0; taskIndex < numTasks; ++taskIndex)
+    {
+        tasks[taskIndex].function = function;
+        tasks[taskIndex].context = context;
+        tasks[taskIndex].taskIndex = taskIndex;
+        tasks[taskIndex].numRemaining = &numRemaining;
+        tasks[taskIndex].claimed.store(false, std::memory_order_release);
+    }
+
+    pool.runTasks(tasks.get(), numTasks);
+}
+
+// copies left behind drain within a few milliseconds, as idle workers scan every queue
+void WorkerTaskGroup::waitForQueuedCopies()
+{
+    for (int taskIndex = 0; taskIndex < capacity; ++taskIndex)
+    {
+        while (tasks[taskIndex].numQueuedCopies.load(std::memory_order_acquire) > 0)
+            std::this_thread::yield();
+    }
+}
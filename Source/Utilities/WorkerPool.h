@@ -0,0 +1,110 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <JuceHeader.h>
+#include "WorkStealingDeque.h"
+#include "MpmcQueue.h"
+#include "WakeEvent.h"
+
+#define WORKER_POOL_MAX_WORKERS 32
+#define WORKER_POOL_DEQUE_SIZE 256
+#define WORKER_POOL_INBOX_SIZE 256
+#define WORKER_POOL_IDLE_SPINS 2000
+#define WORKER_POOL_IDLE_WAIT_MS 2
+
+// one unit of real-time work; owned by whoever submits it, never by the pool
+struct WorkerTask
+{
+	using Function = void (*)(void *context, int taskIndex);
+
+	Function function{ nullptr };
+	void *context{ nullptr };
+	int taskIndex{ 0 };
+	std::atomic<int> *numRemaining{ nullptr };
+
+	// set by whichever thread runs the task, so a copy still queued elsewhere is skipped
+	std::atomic<bool> claimed{ false };
+
+	// copies on a worker's deque or inbox; the task storage must outlive them
+	std::atomic<int> numQueuedCopies{ 0 };
+};
+
+// process-wide scheduler shared by every plugin instance through a
+// SharedResourcePointer, so forty instances still run one thread per core.
+// real-time tasks go to high priority workers that each own a work-stealing
+// deque; background jobs (table loading, caches, gui renders) run on a
+// separate background-priority thread and never delay a render
+class WorkerPool
+{
+public:
+
+	//=============================================================================
+	WorkerPool();
+	~WorkerPool();
+
+	int getNumWorkers() const;
+
+	//=============================================================================
+	// REAL-TIME
+
+	// runs every task and returns once all have finished; the calling thread helps with
+	// this batch only. nothing here locks or allocates: waking a sleeping worker is an atomic
+	// update plus a semaphore post
+	void runTasks(WorkerTask *tasks, int numTasks);
+
+	//=============================================================================
+	// BACKGROUND
+
+	void addBackgroundJob(juce::ThreadPoolJob *job, bool deleteJobWhenFinished);
+	void addBackgroundJob(std::function<void()> job);
+
+	// removes queued jobs the selector accepts and interrupts running ones, waiting
+	// up to timeoutMilliseconds for those to return
+	bool removeBackgroundJobs(std::function<bool(juce::ThreadPoolJob *)> selector, int timeoutMilliseconds);
+
+private:
+	//=============================================================================
+	class Worker;
+	juce::OwnedArray<Worker> workers;
+
+	// where the next batch from outside the pool starts handing out tasks
+	std::atomic<unsigned int> nextWorkerIndex{ 0 };
+
+	juce::ThreadPool backgroundPool;
+
+	WorkerTask *findTask(int workerIndex);
+	void wakeWorkers(int numToWake);
+	static void waitForBatch(WorkerTask *tasks, int numTasks);
+
+	static void execute(WorkerTask *task);
+	static void executeQueued(WorkerTask *task);
+
+	JUCE_DECLARE_NON_COPYABLE(WorkerPool)
+};
+
+// a fork-join batch with preallocated task storage, e.g. one task per voice
+class WorkerTaskGroup
+{
+public:
+
+	//=============================================================================
+	~WorkerTaskGroup();
+
+	// allocates, so never call from the audio thread
+	void prepare(int maximumNumTasks);
+
+	// runs function(context, index) for every index below numTasks across the pool
+	void run(WorkerPool &pool, WorkerTask::Function function, void *context, int numTasks);
+
+private:
+	//=============================================================================
+	// constructed, not just zeroed, since the tasks hold atomics
+	std::unique_ptr<WorkerTask[]> tasks;
+	int capacity{ 0 };
+	std::atomic<int> numRemaining{ 0 };
+
+	// the pool may still hold copies of tasks the submitter ran itself
+	void waitForQueuedCopies();
+};
+
+#endif // WORKER_POOL_H